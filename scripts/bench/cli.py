@@ -12,6 +12,8 @@ from bench.elo_search import cmd_elo
 from bench.gauntlet import cmd_gauntlet
 from bench.run import cmd_run
 from bench.run_all import cmd_run_all
+from bench.speedtest import cmd_speedtest
+from bench.treedump import FLAG_NAMES, cmd_treedump
 
 
 def _build_parser() -> argparse.ArgumentParser:
@@ -212,6 +214,70 @@ def _build_parser() -> argparse.ArgumentParser:
     )
     elo_parser.set_defaults(func=cmd_elo)
 
+    # --- speedtest ---
+    speedtest_parser = subparsers.add_parser(
+        "speedtest", help="Compare the NPS of two engine binaries"
+    )
+    speedtest_parser.add_argument(
+        "--base", metavar="PATH", required=True,
+        help="Baseline engine binary",
+    )
+    speedtest_parser.add_argument(
+        "--new", metavar="PATH", default=None,
+        help="Candidate engine binary (default: engine_binary from config)",
+    )
+    speedtest_parser.add_argument(
+        "--pairs", type=int, default=20,
+        help="Number of interleaved base/new runs (default: 20)",
+    )
+    speedtest_parser.add_argument(
+        "--depth", type=int, default=6,
+        help="Search depth per position (default: 6)",
+    )
+    speedtest_parser.add_argument(
+        "--hash", type=int, default=16,
+        help="Hash size in MB (default: 16)",
+    )
+    speedtest_parser.set_defaults(func=cmd_speedtest)
+
+    # --- treedump ---
+    treedump_parser = subparsers.add_parser(
+        "treedump", help="Query a search tree dump"
+    )
+    treedump_parser.add_argument(
+        "file", help="Dump written by the engine's treedump command",
+    )
+    treedump_queries = treedump_parser.add_subparsers(dest="query", required=True)
+    treedump_queries.add_parser("summary", help="Node counts per ply and flag")
+    node_parser = treedump_queries.add_parser("node", help="A node and its children")
+    node_parser.add_argument("id", type=int)
+    path_parser = treedump_queries.add_parser(
+        "path", help="The nodes from the root down to a node"
+    )
+    path_parser.add_argument("id", type=int)
+    top_parser = treedump_queries.add_parser("top", help="Largest subtrees")
+    top_parser.add_argument(
+        "--count", type=int, default=20,
+        help="Number of subtrees to list (default: 20)",
+    )
+    top_parser.add_argument(
+        "--ply", type=int, default=None,
+        help="Only subtrees rooted at this ply",
+    )
+    find_parser = treedump_queries.add_parser(
+        "find", help="Nodes that have all the given flags"
+    )
+    find_parser.add_argument("flag", nargs="+", choices=FLAG_NAMES)
+    find_parser.add_argument(
+        "--count", type=int, default=50,
+        help="Maximum number of nodes to list (default: 50)",
+    )
+    find_parser.add_argument(
+        "--ply", type=int, default=None,
+        help="Only nodes at this ply",
+    )
+    treedump_parser.set_defaults(func=cmd_treedump)
+
     return parser
 
 
@@ -2,6 +2,7 @@
 
 from __future__ import annotations
 
+import json
 import re
 from dataclasses import dataclass, field
 
@@ -29,6 +30,15 @@ class BenchmarkResult:
     categories: dict[str, CategoryResult] = field(default_factory=dict)
 
 
+@dataclass
+class SpeedSample:
+    """One ``blunder speedtest`` round: a pass over the bench positions."""
+
+    nodes: int
+    time_secs: float
+    nps: int
+
+
 @dataclass
 class GauntletResult:
     """Parsed result from a fast-chess gauntlet run."""
@@ -51,6 +61,8 @@ _RE_NPS = re.compile(r"NPS=(\d+)")
 _RE_TOTALS = re.compile(r"Nodes=(\d+) Time=(\d+\.\d+)s")
 _RE_CATEGORY = re.compile(r"\s+(.+?):\s+(\d+\.\d+)% \((\d+)/(\d+), (\d+) pos\)")
 
+_RE_SPEED_SAMPLE = re.compile(r"^sample \d+ nodes (\d+) time (\d+\.?\d*) nps (\d+)", re.MULTILINE)
+
 # ---------------------------------------------------------------------------
 # Regex patterns for fast-chess output parsing
 # ---------------------------------------------------------------------------
@@ -112,6 +124,50 @@ def parse_benchmark_output(stdout: str) -> BenchmarkResult:
     )
 
 
+def parse_json_output(stdout: str) -> tuple[BenchmarkResult, list[dict]]:
+    """Parse ``blunder --test-positions <epd> --json`` output.
+
+    The JSON object is the last non-empty line. Returns the summary as a
+    ``BenchmarkResult`` and the per-position records (id, category, move,
+    expected, score, max_score, nodes, time_secs, depth, tt_hit_rate) as
+    dicts. Raises ``ValueError`` if no JSON object is found.
+    """
+    lines = [line for line in stdout.splitlines() if line.strip()]
+    if not lines:
+        raise ValueError("Could not parse JSON from benchmark output")
+    try:
+        data = json.loads(lines[-1])
+        summary = data["summary"]
+    except (json.JSONDecodeError, KeyError, TypeError) as exc:
+        raise ValueError("Could not parse JSON from benchmark output") from exc
+
+    categories = {
+        name: CategoryResult(
+            score=cat["score"], max_score=cat["max_score"], positions=cat["positions"]
+        )
+        for name, cat in data.get("categories", {}).items()
+    }
+    result = BenchmarkResult(
+        score_pct=float(summary["score_pct"]),
+        score=summary["score"],
+        max_score=summary["max_score"],
+        elo=summary["elo"],
+        nps=summary["nps"],
+        nodes=summary["nodes"],
+        time_secs=float(summary["time_secs"]),
+        categories=categories,
+    )
+    return result, data.get("positions", [])
+
+
+def parse_speedtest_output(stdout: str) -> list[SpeedSample]:
+    """Parse ``blunder speedtest`` stdout into its raw samples, in order."""
+    return [
+        SpeedSample(nodes=int(m.group(1)), time_secs=float(m.group(2)), nps=int(m.group(3)))
+        for m in _RE_SPEED_SAMPLE.finditer(stdout)
+    ]
+
+
 def parse_fastchess_output(stdout: str) -> GauntletResult:
     """Parse fast-chess stdout for W/L/D, Elo diff, SPRT result.
 
@@ -0,0 +1,142 @@
+"""Speed comparison of two engine binaries.
+
+Runs ``blunder speedtest <depth> 1`` alternately on a baseline and a
+candidate binary (ABBA order, so drift in machine load hits both equally)
+and reports the mean NPS of each and the paired NPS delta with a 95%
+confidence interval. Each run searches the same fixed positions, so a
+single sample is one pass over them; the engine times only the searches.
+
+If the two binaries report different node counts, the search itself
+changed and the delta is not a pure speed comparison.
+"""
+
+from __future__ import annotations
+
+import argparse
+import math
+import statistics
+import subprocess
+import sys
+from dataclasses import dataclass
+
+from bench.config import Config
+from bench.parsers import SpeedSample, parse_speedtest_output
+
+# Two-sided 95% Student t critical values by degrees of freedom
+_T95 = {
+    1: 12.706, 2: 4.303, 3: 3.182, 4: 2.776, 5: 2.571, 6: 2.447, 7: 2.365,
+    8: 2.306, 9: 2.262, 10: 2.228, 11: 2.201, 12: 2.179, 13: 2.160,
+    14: 2.145, 15: 2.131, 16: 2.120, 17: 2.110, 18: 2.101, 19: 2.093,
+    20: 2.086, 25: 2.060, 30: 2.042, 40: 2.021, 60: 2.000, 120: 1.980,
+}
+
+
+def t_critical_95(df: int) -> float:
+    """Two-sided 95% t critical value, conservative between table entries."""
+    if df < 1:
+        return math.inf
+    for key in sorted(_T95):
+        if df <= key:
+            return _T95[key]
+    return 1.960
+
+
+@dataclass
+class SpeedComparison:
+    """Paired NPS comparison of a candidate against a baseline."""
+
+    pairs: int
+    base_mean_nps: float
+    new_mean_nps: float
+    delta_pct: float     # mean of per-pair (new / base - 1) * 100
+    ci_pct: float        # half-width of the 95% confidence interval
+    nodes_match: bool    # both binaries searched the same trees
+
+
+def compare_samples(base: list[SpeedSample], new: list[SpeedSample]) -> SpeedComparison:
+    """Compare paired samples (base[i] and new[i] were run back to back).
+
+    Raises ``ValueError`` if there are no pairs or the lists differ in length.
+    """
+    if not base or len(base) != len(new):
+        raise ValueError("Need the same, non-zero number of samples per binary")
+
+    deltas = [100.0 * (n.nps / b.nps - 1.0) for b, n in zip(base, new) if b.nps > 0]
+    if not deltas:
+        raise ValueError("Baseline samples report zero NPS")
+    ci = 0.0
+    if len(deltas) > 1:
+        sem = statistics.stdev(deltas) / math.sqrt(len(deltas))
+        ci = t_critical_95(len(deltas) - 1) * sem
+
+    return SpeedComparison(
+        pairs=len(deltas),
+        base_mean_nps=statistics.mean(s.nps for s in base),
+        new_mean_nps=statistics.mean(s.nps for s in new),
+        delta_pct=statistics.mean(deltas),
+        ci_pct=ci,
+        nodes_match=all(b.nodes == n.nodes for b, n in zip(base, new)),
+    )
+
+
+def format_comparison(c: SpeedComparison) -> str:
+    """Human-readable summary of a comparison."""
+    sign = "+" if c.delta_pct >= 0 else ""
+    lines = [
+        f"Pairs:         {c.pairs}",
+        f"Baseline NPS:  {c.base_mean_nps:,.0f}",
+        f"Candidate NPS: {c.new_mean_nps:,.0f}",
+        f"NPS delta:     {sign}{c.delta_pct:.2f}% +/- {c.ci_pct:.2f}% (95% CI)",
+    ]
+    if c.ci_pct > 0 and abs(c.delta_pct) > c.ci_pct:
+        lines.append("Result:        significant")
+    else:
+        lines.append("Result:        not significant")
+    if not c.nodes_match:
+        lines.append("Warning:       node counts differ, the search changed")
+    return "\n".join(lines)
+
+
+def _run_once(binary: str, depth: int, hash_mb: int, dry_run: bool) -> SpeedSample | None:
+    cmd = [binary, "speedtest", str(depth), "1", str(hash_mb)]
+    if dry_run:
+        print(" ".join(cmd))
+        return None
+    try:
+        proc = subprocess.run(cmd, capture_output=True, text=True, check=False)
+    except FileNotFoundError:
+        print(f"Error: binary not found: {binary}", file=sys.stderr)
+        return None
+    samples = parse_speedtest_output(proc.stdout)
+    if not samples:
+        print(f"Error: no speedtest samples from {binary}", file=sys.stderr)
+        return None
+    return samples[0]
+
+
+def cmd_speedtest(config: Config, args: argparse.Namespace) -> int:
+    """Interleave speedtest runs of two binaries and compare their NPS."""
+    base_bin = args.base
+    new_bin = args.new or str(config.paths.engine_binary)
+
+    base: list[SpeedSample] = []
+    new: list[SpeedSample] = []
+    for i in range(args.pairs):
+        # ABBA: alternate which binary runs first in each pair
+        order = [(base_bin, base), (new_bin, new)]
+        if i % 2 == 1:
+            order.reverse()
+        for binary, samples in order:
+            sample = _run_once(binary, args.depth, args.hash, args.dry_run)
+            if sample is None:
+                if args.dry_run:
+                    continue
+                return 1
+            samples.append(sample)
+        if args.verbose and not args.dry_run:
+            print(f"pair {i + 1}: base {base[-1].nps} nps, new {new[-1].nps} nps")
+
+    if args.dry_run:
+        return 0
+    print(format_comparison(compare_samples(base, new)))
+    return 0
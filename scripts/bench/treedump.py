@@ -0,0 +1,180 @@
+"""Reader and queries for search tree dumps.
+
+An engine configured with ``-Dblunder_SEARCH_TREE_DUMP=ON`` writes the tree
+of each search after the UCI command ``treedump <file> [nodes]``. The file
+is the magic ``BLTREE1\\0``, a little-endian u32 record size, then one
+fixed-size record per alphabeta/quiesce node in post-order (see
+source/SearchTreeDump.h). ``load_tree`` rebuilds the parent/child links;
+the ``treedump`` subcommand summarizes and queries the result.
+"""
+
+from __future__ import annotations
+
+import argparse
+import struct
+from collections import Counter
+from dataclasses import dataclass, field
+
+from bench.config import Config
+
+MAGIC = b"BLTREE1\0"
+_RECORD = struct.Struct("<QIIIiiiHbBBBBB")
+
+# TreeDumpFlag bits, in bit order
+FLAG_NAMES = [
+    "qnode", "tt_cutoff", "draw", "null_try", "null_cutoff", "rfp",
+    "singular_try", "singular_ext", "check_ext", "beta_cutoff", "stand_pat",
+    "null_move", "singular_verify", "lmr", "zero_window", "research",
+]
+FLAGS = {name: 1 << bit for bit, name in enumerate(FLAG_NAMES)}
+
+_FILES = "abcdefgh"
+_KING_CASTLE = 64 << 16
+_QUEEN_CASTLE = 128 << 16
+
+
+@dataclass
+class Node:
+    """One searched node; ``children`` are in search order."""
+
+    hash: int
+    id: int
+    parent: int
+    move: int
+    alpha: int
+    beta: int
+    result: int
+    flags: int
+    depth: int
+    ply: int
+    moves_searched: int
+    futility_prunes: int
+    lmp_prunes: int
+    see_prunes: int
+    children: list[int] = field(default_factory=list)
+
+    def flag_names(self) -> list[str]:
+        return [name for name, bit in FLAGS.items() if self.flags & bit]
+
+
+@dataclass
+class Tree:
+    nodes: dict[int, Node]
+    roots: list[int]          # one per root search (iteration, re-search)
+
+    def path(self, node_id: int) -> list[Node]:
+        """Nodes from the root down to ``node_id``."""
+        out = []
+        while node_id in self.nodes:
+            out.append(self.nodes[node_id])
+            node_id = self.nodes[node_id].parent
+        return out[::-1]
+
+
+def parse_records(data: bytes) -> list[Node]:
+    """Decode a dump file's contents. Raises ``ValueError`` on a bad header."""
+    if data[:8] != MAGIC:
+        raise ValueError("Not a search tree dump (bad magic)")
+    (size,) = struct.unpack_from("<I", data, 8)
+    if size != _RECORD.size:
+        raise ValueError(f"Unsupported record size {size}, expected {_RECORD.size}")
+    nodes = []
+    for offset in range(12, len(data) - size + 1, size):
+        nodes.append(Node(*_RECORD.unpack_from(data, offset)))
+    return nodes
+
+
+def build_tree(records: list[Node]) -> Tree:
+    """Link records into a tree. Records are post-order, ids are pre-order."""
+    nodes = {n.id: n for n in records}
+    roots = []
+    for n in sorted(records, key=lambda r: r.id):
+        if n.parent in nodes:
+            nodes[n.parent].children.append(n.id)
+        else:
+            roots.append(n.id)
+    return Tree(nodes=nodes, roots=roots)
+
+
+def load_tree(path: str) -> Tree:
+    with open(path, "rb") as f:
+        return build_tree(parse_records(f.read()))
+
+
+def move_str(move: int) -> str:
+    """Coordinate notation of a Move_t (source/Move.h: from in bits 0-5,
+    to in bits 6-11, castling as a bare flag)."""
+    if move == 0:
+        return "-"
+    if move & _KING_CASTLE:
+        return "O-O"
+    if move & _QUEEN_CASTLE:
+        return "O-O-O"
+    frm, to = move & 63, (move >> 6) & 63
+    return f"{_FILES[frm % 8]}{frm // 8 + 1}{_FILES[to % 8]}{to // 8 + 1}"
+
+
+def format_node(n: Node) -> str:
+    prunes = ""
+    if n.futility_prunes or n.lmp_prunes or n.see_prunes:
+        prunes = f" pruned f{n.futility_prunes}/l{n.lmp_prunes}/s{n.see_prunes}"
+    return (
+        f"#{n.id} ply {n.ply} depth {n.depth} move {move_str(n.move)} "
+        f"window [{n.alpha}, {n.beta}] result {n.result} "
+        f"moves {n.moves_searched}{prunes} {','.join(n.flag_names())}"
+    ).rstrip()
+
+
+def summarize(tree: Tree) -> str:
+    """Node counts per ply and per flag."""
+    per_ply = Counter(n.ply for n in tree.nodes.values())
+    per_flag = Counter(name for n in tree.nodes.values() for name in n.flag_names())
+    lines = [f"nodes {len(tree.nodes)} roots {len(tree.roots)}", "ply  nodes"]
+    lines += [f"{ply:3d}  {per_ply[ply]}" for ply in sorted(per_ply)]
+    lines.append("flag            nodes")
+    lines += [f"{name:15s} {per_flag[name]}" for name in FLAG_NAMES if per_flag[name]]
+    return "\n".join(lines)
+
+
+def largest_subtrees(tree: Tree, count: int, ply: int | None = None) -> list[tuple[int, Node]]:
+    """The ``count`` largest subtrees, optionally only those rooted at ``ply``."""
+    sizes: dict[int, int] = {}
+    # Children have larger ids than their parents, so sum from the leaves up
+    for node_id in sorted(tree.nodes, reverse=True):
+        n = tree.nodes[node_id]
+        sizes[node_id] = 1 + sum(sizes[c] for c in n.children)
+    candidates = [i for i in tree.nodes if ply is None or tree.nodes[i].ply == ply]
+    candidates.sort(key=lambda i: sizes[i], reverse=True)
+    return [(sizes[i], tree.nodes[i]) for i in candidates[:count]]
+
+
+def cmd_treedump(config: Config, args: argparse.Namespace) -> int:
+    """Summarize or query a search tree dump."""
+    tree = load_tree(args.file)
+    if args.query == "summary":
+        print(summarize(tree))
+    elif args.query == "node":
+        n = tree.nodes[args.id]
+        print(format_node(n))
+        for c in n.children:
+            print("  " + format_node(tree.nodes[c]))
+    elif args.query == "path":
+        for n in tree.path(args.id):
+            print(format_node(n))
+    elif args.query == "top":
+        for size, n in largest_subtrees(tree, args.count, args.ply):
+            print(f"{size:9d}  {format_node(n)}")
+    elif args.query == "find":
+        bits = 0
+        for name in args.flag:
+            bits |= FLAGS[name]
+        shown = 0
+        for node_id in sorted(tree.nodes):
+            n = tree.nodes[node_id]
+            if (n.flags & bits) == bits and (args.ply is None or n.ply == args.ply):
+                print(format_node(n))
+                shown += 1
+                if shown >= args.count:
+                    break
+    return 0
+
@@ -77,17 +77,35 @@ class DualHeadNNUE(nn.Module):
         return v, p
 
 
+# MCTS training files start with this magic and a u32 format version.
+# Files without it are version 1, which stored each move as a 32-bit
+# from*64+to index; version 2 stores 16-bit PackedMoves.
+MCTS_MAGIC = b'BLMCTS\0\0'
+MCTS_VERSION = 2
+
+
+def read_mcts_header(data: bytes):
+    """Return (format version, offset of the first entry) of MCTS data."""
+    if data[:len(MCTS_MAGIC)] != MCTS_MAGIC:
+        return 1, 0
+    version = struct.unpack_from('<I', data, len(MCTS_MAGIC))[0]
+    if version != MCTS_VERSION:
+        raise ValueError(f"unsupported MCTS training data version {version}")
+    return version, len(MCTS_MAGIC) + 4
+
+
 class MCTSPolicyDataset(Dataset):
     """Dataset for MCTS self-play data with policy and value targets.
 
     Reads the variable-length binary format produced by SelfPlay.cpp
     and returns (features, policy_target, move_mask, value_target) tuples.
 
-    Binary format per entry:
+    Binary format: the MCTS_MAGIC header (see read_mcts_header), then
+    per entry:
         768 floats:       features (HalfKP binary features)
         1 int:            num_moves
         num_moves floats: policy (normalized visit distribution)
-        num_moves ints:   move_indices (from*64+to, each in [0, 4096))
+        num_moves u16s:   moves (PackedMove: from in bits 0-5, to in bits 6-11)
         1 float:          value (game outcome: +1=win, 0=draw, -1=loss)
     """
 
@@ -105,7 +123,7 @@ class MCTSPolicyDataset(Dataset):
         self.move_masks = []
         self.value_targets = []
 
-        offset = 0
+        version, offset = read_mcts_header(data)
         features_bytes = 768 * 4
 
         while offset + features_bytes + 4 < len(data):
@@ -120,16 +138,25 @@ class MCTSPolicyDataset(Dataset):
             if num_moves <= 0 or num_moves > 256:
                 break  # corrupt data guard
 
-            # Read policy (visit distribution) and move_indices
+            # Read policy (visit distribution) and packed moves
             policy_vals = struct.unpack_from(
                 f'{num_moves}f', data, offset
             )
             offset += num_moves * 4
 
-            move_indices = struct.unpack_from(
-                f'{num_moves}i', data, offset
-            )
-            offset += num_moves * 4
+            if version == 1:
+                move_indices = struct.unpack_from(
+                    f'{num_moves}i', data, offset
+                )
+                offset += num_moves * 4
+            else:
+                packed_moves = struct.unpack_from(
+                    f'{num_moves}H', data, offset
+                )
+                offset += num_moves * 2
+                # Policy index from*64+to, as in DualHeadNetwork
+                move_indices = [(m & 63) * 64 + ((m >> 6) & 63)
+                                for m in packed_moves]
 
             # Read value (game outcome)
             value = struct.unpack_from('f', data, offset)[0]
@@ -87,6 +87,23 @@ class NNUEDataset(Dataset):
         return self.features[idx], self.targets[idx]
 
 
+# MCTS training files start with this magic and a u32 format version.
+# Files without it are version 1, which stored each move as a 32-bit
+# from*64+to index; version 2 stores 16-bit PackedMoves.
+MCTS_MAGIC = b'BLMCTS\0\0'
+MCTS_VERSION = 2
+
+
+def read_mcts_header(data: bytes):
+    """Return (format version, offset of the first entry) of MCTS data."""
+    if data[:len(MCTS_MAGIC)] != MCTS_MAGIC:
+        return 1, 0
+    version = struct.unpack_from('<I', data, len(MCTS_MAGIC))[0]
+    if version != MCTS_VERSION:
+        raise ValueError(f"unsupported MCTS training data version {version}")
+    return version, len(MCTS_MAGIC) + 4
+
+
 class MCTSDataset(Dataset):
     """Dataset for MCTS self-play training data (variable-length format).
     
@@ -98,11 +115,12 @@ class MCTSDataset(Dataset):
     def __init__(self, data_path: str):
         """Load MCTS training data from binary file.
         
-        Format per entry (variable length):
+        Format: the MCTS_MAGIC header (see read_mcts_header), then per
+        entry (variable length):
             768 floats: features
             1 int:      num_moves
             num_moves floats: policy (normalized visit distribution)
-            num_moves ints:   move_indices (from*64+to encoding)
+            num_moves u16s:   moves (PackedMove, see source/Move.h)
             1 float:   value (game outcome: +1=win, 0=draw, -1=loss)
         """
         with open(data_path, 'rb') as f:
@@ -111,7 +129,8 @@ class MCTSDataset(Dataset):
         self.features = []
         self.targets = []
         
-        offset = 0
+        version, offset = read_mcts_header(data)
+        move_bytes = 4 if version == 1 else 2
         features_bytes = 768 * 4
         
         while offset + features_bytes + 4 < len(data):
@@ -123,9 +142,9 @@ class MCTSDataset(Dataset):
             num_moves = struct.unpack_from('i', data, offset)[0]
             offset += 4
             
-            # Skip policy (num_moves floats) and move_indices (num_moves ints)
+            # Skip policy (num_moves floats) and moves
             offset += num_moves * 4  # policy
-            offset += num_moves * 4  # move_indices
+            offset += num_moves * move_bytes  # moves
             
             # Read value
             value = struct.unpack_from('f', data, offset)[0]
@@ -0,0 +1,405 @@
+/*
+ * File:   Bench.cpp
+ *
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "Bench.h"
+
+#include "Board.h"
+#include "CoachJson.h"
+#include "MoveGenerator.h"
+#include "NNUEEvaluator.h"
+#include "Parser.h"
+#include "Search.h"
+#include "Trace.h"
+
+// Openings, middlegames and endgames of varying sharpness, including the
+// standard perft test positions. Changing this list changes the signature.
+const char* const BENCH_FENS[] = {
+    // Openings
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r1bqkbnr/pppp1ppp/2n5/1B2p3/4P3/5N2/PPPP1PPP/RNBQK2R b KQkq - 3 3",
+    "rnbqkb1r/pp2pppp/3p1n2/8/3NP3/8/PPP2PPP/RNBQKB1R w KQkq - 1 5",
+    "rnbqk2r/ppp1ppbp/3p1np1/8/2PPP3/2N5/PP3PPP/R1BQKBNR w KQkq - 0 5",
+    "r1bqk2r/pppp1ppp/2n2n2/2b1p3/2B1P3/3P1N2/PPP2PPP/RNBQK2R w KQkq - 1 5",
+    "rnbqkb1r/ppp2ppp/4pn2/3p2B1/2PP4/2N5/PP2PPPP/R2QKBNR b KQkq - 3 4",
+    "rnbqkb1r/pp1p1ppp/4pn2/2p5/2PP4/2N5/PP2PPPP/R1BQKBNR w KQkq - 0 4",
+
+    // Perft test positions
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 10",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 11",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+
+    // Middlegames
+    "4rrk1/pp1n3p/3q2pQ/2p1pb2/2PP4/2P3N1/P2B2PP/4RRK1 b - - 7 19",
+    "rq3rk1/ppp2ppp/1bnpb3/3N2B1/3NP3/7P/PPPQ1PP1/2KR3R w - - 7 14",
+    "r1bq1r1k/1pp1n1pp/1p1p4/4p2Q/4Pp2/1BNP4/PPP2PPP/3R1RK1 w - - 2 14",
+    "r3r1k1/2p2ppp/p1p1bn2/8/1q2P3/2NPQN2/PPP3PP/R4RK1 b - - 2 15",
+    "r1bbk1nr/pp3p1p/2n5/1N4p1/2Np1B2/8/PPP2PPP/2KR1B1R w kq - 0 13",
+    "r1bq1rk1/ppp1nppp/4n3/3p3Q/3P4/1BP1B3/PP1N2PP/R4RK1 w - - 1 16",
+    "4r1k1/r1q2ppp/ppp2n2/4P3/5Rb1/1N1BQ3/PPP3PP/R5K1 w - - 1 17",
+    "2rqkb1r/ppp2p2/2npb1p1/1N1Nn2p/2P1PP2/8/PP2B1PP/R1BQK2R b KQ - 0 11",
+    "r1bq1r1k/b1p1npp1/p2p3p/1p6/3PP3/1B2NN2/PP3PPP/R2Q1RK1 w - - 1 16",
+    "3r1rk1/p5pp/bpp1pp2/8/q1PP1P2/b3P3/P2NQRPP/1R2B1K1 b - - 6 22",
+    "r1q2rk1/2p1bppp/2Pp4/p6b/Q1PNp3/4B3/PP1R1PPP/2K4R w - - 2 18",
+    "4k2r/1pb2ppp/1p2p3/1R1p4/3P4/2r1PN2/P4PPP/1R4K1 b - - 3 22",
+    "3q2k1/pb3p1p/4pbp1/2r5/PpN2N2/1P2P2P/5PP1/Q2R2K1 b - - 4 26",
+    "2r2rk1/pp3ppp/2n1b3/q2pP3/3P4/P1PB1N2/2Q2PPP/R4RK1 w - - 0 16",
+    "r2q1rk1/pb1nbppp/1p2pn2/2pp4/2PP4/1PN1PN2/PB2BPPP/R2Q1RK1 w - - 0 10",
+    "r1b2rk1/2q1bppp/p2ppn2/1p6/3BPP2/2N2B2/PPP3PP/R2Q1R1K w - - 0 14",
+    "2kr3r/ppp2ppp/2n5/2b1p3/4P1b1/2NP1N2/PPP2PPP/R1B1KB1R w KQ - 0 9",
+    "6k1/3b3r/1p1p4/p1n2p2/1PPNpP1q/P3Q1p1/1R1RB1P1/5K2 b - - 0 1",
+    "r2r1n2/pp2bk2/2p1p2p/3q4/3PN1QP/2P3R1/P4PP1/5RK1 w - - 0 1",
+
+    // Endgames
+    "6k1/6p1/6Pp/ppp5/3pn2P/1P3K2/1PP2P2/8 b - - 0 1",
+    "8/8/8/8/5kp1/P7/8/1K1N4 w - - 0 1",
+    "8/8/8/5N2/8/p7/8/2NK3k w - - 0 1",
+    "8/3k4/8/8/8/4B3/4KB2/2B5 w - - 0 1",
+    "8/8/1P6/5pr1/8/4R3/7k/2K5 w - - 0 1",
+    "8/2p4P/8/kr6/6R1/8/8/1K6 w - - 0 1",
+    "8/8/3P3k/8/1p6/8/1P6/1K3n2 b - - 0 1",
+    "8/R7/2q5/8/6k1/8/1P5p/K6R w - - 0 124",
+    "8/pp3k2/2p1rpp1/3p4/3P1P2/2P1R1P1/PP4K1/8 w - - 0 30",
+    "8/1p4kp/p5p1/8/P7/1P4PP/6K1/8 w - - 0 1",
+    "8/5pk1/6p1/8/5P2/6P1/5K2/8 w - - 0 1",
+    "8/8/4k3/3p4/3P4/4K3/8/8 w - - 0 1",
+    "4k3/8/8/8/8/8/4P3/4K3 w - - 0 1",
+    "8/8/8/4k3/8/8/3QK3/8 w - - 0 1",
+    "8/8/8/4k3/8/8/3RK3/8 w - - 0 1",
+    "8/8/8/8/8/6k1/6p1/6K1 w - - 0 1",
+    "7k/7P/6K1/8/3B4/8/8/8 b - - 0 1",
+
+    // Mates and tactics
+    "6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1",
+    "k1r5/1R3R2/2r3p1/p4p1p/5Q2/1P6/PKP2PPP/5q2 b - - 0 1",
+};
+
+const int NUM_BENCH_FENS = static_cast<int>(sizeof(BENCH_FENS) / sizeof(BENCH_FENS[0]));
+
+// Search one position with a fresh Board, hash table and Search. Only the
+// search itself is timed (search_secs): allocating the hash table is not.
+static U64 bench_position(const char* fen,
+                          const BenchConfig& config,
+                          NNUEEvaluator* nnue,
+                          double& search_secs,
+                          SearchTreeStats& tree_stats,
+                          LazyEvalStats& lazy_stats)
+{
+    Board board = Parser::parse_fen(fen);
+    board.get_tt().resize(config.hash_mb);
+    if (nnue)
+    {
+        board.set_nnue(nnue);
+        nnue->refresh(board);
+    }
+
+    Search search(board);
+    search.set_output_mode(Search::OutputMode::SILENT);
+    search.get_tm().start(-1, -1);  // depth is the only limit
+    search.set_abort(false);
+    auto start = std::chrono::steady_clock::now();
+    search.search(config.depth, -1, -1);
+    search_secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (SEARCH_TREE_STATS)
+    {
+        tree_stats += search.get_tree_stats();
+    }
+    lazy_stats += board.get_hce().lazy_stats();
+    return search.get_stats().nodes_visited;
+}
+
+static const char* slider_backend_name()
+{
+    return MoveGenerator::slider_backend() == MoveGenerator::SliderBackend::PEXT ? "pext"
+                                                                                 : "magic";
+}
+
+BenchResult bench(const BenchConfig& config, std::ostream& os)
+{
+    BenchResult result;
+    result.position_nodes.assign(static_cast<size_t>(NUM_BENCH_FENS), 0);
+    result.position_secs.assign(static_cast<size_t>(NUM_BENCH_FENS), 0.0);
+
+    // Board::reset() runs the one-time table initialization; do it here,
+    // before any worker thread parses a position.
+    Parser::parse_fen(BENCH_FENS[0]);
+    Trace::reset();
+
+    int threads = std::max(1, std::min(config.threads, NUM_BENCH_FENS));
+    std::atomic<int> next_position {0};
+    std::mutex output_mutex;
+
+    auto worker = [&]()
+    {
+        // The NNUE accumulator is per-search state: one copy per thread
+        std::unique_ptr<NNUEEvaluator> nnue;
+        if (config.nnue)
+        {
+            nnue = std::make_unique<NNUEEvaluator>(*config.nnue);
+        }
+        SearchTreeStats tree_stats;
+        LazyEvalStats lazy_stats;
+        double search_secs = 0.0;
+
+        int i;
+        while ((i = next_position.fetch_add(1)) < NUM_BENCH_FENS)
+        {
+            double secs = 0.0;
+            U64 nodes = bench_position(BENCH_FENS[i], config, nnue.get(), secs, tree_stats,
+                                     lazy_stats);
+            search_secs += secs;
+            result.position_nodes[static_cast<size_t>(i)] = nodes;
+            result.position_secs[static_cast<size_t>(i)] = secs;
+
+            std::lock_guard<std::mutex> lock(output_mutex);
+            os << "Position " << std::setw(2) << (i + 1) << "/" << NUM_BENCH_FENS
+               << "  nodes " << std::setw(10) << nodes << "  " << BENCH_FENS[i] << std::endl;
+        }
+
+        // Workers run side by side: the busiest one sets the elapsed time
+        std::lock_guard<std::mutex> lock(output_mutex);
+        result.tree_stats += tree_stats;
+        result.lazy_eval += lazy_stats;
+        result.elapsed_secs = std::max(result.elapsed_secs, search_secs);
+    };
+
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; t++)
+    {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : pool)
+    {
+        thread.join();
+    }
+
+    for (U64 nodes : result.position_nodes)
+    {
+        result.nodes += nodes;
+    }
+    result.nps = (result.elapsed_secs > 0.0)
+        ? static_cast<U64>(static_cast<double>(result.nodes) / result.elapsed_secs)
+        : 0;
+
+    if (SEARCH_TREE_STATS)
+    {
+        os << std::endl;
+        result.tree_stats.print(os);
+    }
+    if (TRACING)
+    {
+        os << std::endl;
+        Trace::print(os);
+    }
+
+    os << "===========================" << std::endl;
+    os << "Depth           : " << config.depth << std::endl;
+    os << "Hash (MB)       : " << config.hash_mb << std::endl;
+    os << "Threads         : " << threads << std::endl;
+    os << "Evaluation      : " << (config.nnue ? "nnue" : "hce") << std::endl;
+    os << "Slider attacks  : " << slider_backend_name() << std::endl;
+    os << "Total time (ms) : " << static_cast<long long>(result.elapsed_secs * 1000.0)
+       << std::endl;
+    os << "Nodes searched  : " << result.nodes << std::endl;
+    os << "Nodes/second    : " << result.nps << std::endl;
+    if (!config.nnue && result.lazy_eval.calls > 0)
+    {
+        const LazyEvalStats& lazy = result.lazy_eval;
+        os << "Lazy eval exits : " << lazy.exits << "/" << lazy.calls << " ("
+           << std::fixed << std::setprecision(1)
+           << 100.0 * static_cast<double>(lazy.exits) / static_cast<double>(lazy.calls)
+           << "%, max positional " << lazy.max_positional << ")" << std::defaultfloat << std::endl;
+    }
+    return result;
+}
+
+static int parse_bench_arg(const std::string& s, int fallback)
+{
+    try
+    {
+        return std::stoi(s);
+    }
+    catch (const std::exception&)
+    {
+        return fallback;
+    }
+}
+
+std::string bench_json(const BenchConfig& config, const BenchResult& result)
+{
+    using CoachJson::to_json;
+
+    std::vector<std::string> positions;
+    for (size_t i = 0; i < result.position_nodes.size(); i++)
+    {
+        positions.push_back(CoachJson::object({
+            { "fen", to_json(BENCH_FENS[i]) },
+            { "nodes", std::to_string(result.position_nodes[i]) },
+            { "time_secs", to_json(result.position_secs[i]) },
+        }));
+    }
+    return CoachJson::object({
+        { "depth", to_json(config.depth) },
+        { "hash_mb", to_json(config.hash_mb) },
+        { "threads", to_json(config.threads) },
+        { "eval", to_json(config.nnue ? "nnue" : "hce") },
+        { "sliders", to_json(slider_backend_name()) },
+        { "nodes", std::to_string(result.nodes) },
+        { "time_secs", to_json(result.elapsed_secs) },
+        { "nps", std::to_string(result.nps) },
+        { "positions", CoachJson::array(positions) },
+    });
+}
+
+BenchResult bench_command(const std::vector<std::string>& all_args,
+                          NNUEEvaluator* nnue,
+                          std::ostream& os)
+{
+    std::vector<std::string> args;
+    bool json = false;
+    for (const std::string& arg : all_args)
+    {
+        if (arg == "--json")
+        {
+            json = true;
+        }
+        else
+        {
+            args.push_back(arg);
+        }
+    }
+
+    BenchConfig config;
+    if (args.size() > 0)
+    {
+        config.depth = std::clamp(parse_bench_arg(args[0], config.depth), 1, MAX_SEARCH_PLY - 1);
+    }
+    if (args.size() > 1)
+    {
+        config.hash_mb = std::max(1, parse_bench_arg(args[1], config.hash_mb));
+    }
+    if (args.size() > 2)
+    {
+        config.threads = std::max(1, parse_bench_arg(args[2], config.threads));
+    }
+    if (args.size() > 3 && args[3] == "nnue")
+    {
+        if (nnue && nnue->is_loaded())
+        {
+            config.nnue = nnue;
+        }
+        else if (!json)
+        {
+            os << "NNUE weights not loaded (use --nnue <path>), "
+               << "falling back to hand-crafted evaluation" << std::endl;
+        }
+    }
+    if (!json)
+    {
+        return bench(config, os);
+    }
+
+    std::ostream discard(nullptr);
+    BenchResult result = bench(config, discard);
+    os << bench_json(config, result) << std::endl;
+    return result;
+}
+
+std::vector<BenchResult> speedtest(const BenchConfig& config, int rounds, std::ostream& os)
+{
+    std::vector<BenchResult> samples;
+    std::unique_ptr<NNUEEvaluator> nnue;
+    if (config.nnue)
+    {
+        nnue = std::make_unique<NNUEEvaluator>(*config.nnue);
+    }
+
+    os << "speedtest depth " << config.depth << " hash " << config.hash_mb << " eval "
+       << (config.nnue ? "nnue" : "hce") << " rounds " << rounds << std::endl;
+    for (int round = 1; round <= rounds; round++)
+    {
+        BenchResult sample;
+        SearchTreeStats tree_stats;
+        for (int i = 0; i < NUM_BENCH_FENS; i++)
+        {
+            double secs = 0.0;
+            U64 nodes = bench_position(BENCH_FENS[i], config, nnue.get(), secs, tree_stats,
+                                       sample.lazy_eval);
+            sample.nodes += nodes;
+            sample.elapsed_secs += secs;
+        }
+        sample.nps = (sample.elapsed_secs > 0.0)
+            ? static_cast<U64>(static_cast<double>(sample.nodes) / sample.elapsed_secs)
+            : 0;
+        os << "sample " << round << " nodes " << sample.nodes << " time " << std::fixed
+           << std::setprecision(6) << sample.elapsed_secs << std::defaultfloat << " nps "
+           << sample.nps << std::endl;
+        samples.push_back(sample);
+    }
+
+    double mean = 0.0;
+    for (const BenchResult& sample : samples)
+    {
+        mean += static_cast<double>(sample.nps);
+    }
+    mean /= static_cast<double>(std::max<size_t>(1, samples.size()));
+    double var = 0.0;
+    for (const BenchResult& sample : samples)
+    {
+        double d = static_cast<double>(sample.nps) - mean;
+        var += d * d;
+    }
+    double stdev = (samples.size() > 1) ? std::sqrt(var / static_cast<double>(samples.size() - 1))
+                                        : 0.0;
+    os << "speedtest mean nps " << static_cast<U64>(mean) << " stdev "
+       << static_cast<U64>(stdev) << std::endl;
+    return samples;
+}
+
+std::vector<BenchResult> speedtest_command(const std::vector<std::string>& args,
+                                           NNUEEvaluator* nnue,
+                                           std::ostream& os)
+{
+    BenchConfig config;
+    config.depth = SPEEDTEST_DEFAULT_DEPTH;
+    int rounds = SPEEDTEST_DEFAULT_ROUNDS;
+    if (args.size() > 0)
+    {
+        config.depth = std::clamp(parse_bench_arg(args[0], config.depth), 1, MAX_SEARCH_PLY - 1);
+    }
+    if (args.size() > 1)
+    {
+        rounds = std::max(1, parse_bench_arg(args[1], rounds));
+    }
+    if (args.size() > 2)
+    {
+        config.hash_mb = std::max(1, parse_bench_arg(args[2], config.hash_mb));
+    }
+    if (args.size() > 3 && args[3] == "nnue")
+    {
+        if (nnue && nnue->is_loaded())
+        {
+            config.nnue = nnue;
+        }
+        else
+        {
+            os << "NNUE weights not loaded (use --nnue <path>), "
+               << "falling back to hand-crafted evaluation" << std::endl;
+        }
+    }
+    return speedtest(config, rounds, os);
+}
@@ -0,0 +1,78 @@
+/*
+ * File:   Bench.h
+ *
+ * Built-in search benchmark over a fixed set of embedded positions.
+ *
+ * Every position is searched to a fixed depth with a fresh Search and hash
+ * table, so the total node count is a functional signature of the search:
+ * a patch that should not change the search (a pure speedup) must leave it
+ * unchanged, whatever the thread count or the machine.
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Evaluator.h"
+#include "SearchStats.h"
+#include "Types.h"
+
+class NNUEEvaluator;
+
+constexpr int BENCH_DEFAULT_DEPTH = 8;
+constexpr int BENCH_DEFAULT_HASH_MB = 16;
+constexpr int SPEEDTEST_DEFAULT_DEPTH = 6;
+constexpr int SPEEDTEST_DEFAULT_ROUNDS = 10;
+
+struct BenchConfig
+{
+    int depth = BENCH_DEFAULT_DEPTH;
+    int hash_mb = BENCH_DEFAULT_HASH_MB;
+    int threads = 1;                  // positions searched concurrently
+    NNUEEvaluator* nnue = nullptr;    // nullptr = hand-crafted evaluation
+};
+
+struct BenchResult
+{
+    U64 nodes = 0;
+    double elapsed_secs = 0.0;        // search time only, hash allocation excluded
+    U64 nps = 0;
+    std::vector<U64> position_nodes;  // per position, in BENCH_FENS order
+    std::vector<double> position_secs;
+    SearchTreeStats tree_stats;       // summed over positions (SEARCH_STATS builds)
+    LazyEvalStats lazy_eval;          // summed over positions (hce only)
+};
+
+extern const char* const BENCH_FENS[];
+extern const int NUM_BENCH_FENS;
+
+/// Search every bench position and print per-position nodes and the totals.
+BenchResult bench(const BenchConfig& config, std::ostream& os);
+
+/// Serialize a bench run as one JSON object: the configuration, totals and
+/// per-position fen, nodes and time.
+std::string bench_json(const BenchConfig& config, const BenchResult& result);
+
+/// Parse "[depth] [hash] [threads] [evaltype] [--json]" (evaltype: hce or
+/// nnue) and run the bench. nnue is used for evaltype nnue and must already
+/// be loaded. With --json only bench_json() is printed.
+BenchResult bench_command(const std::vector<std::string>& args,
+                          NNUEEvaluator* nnue,
+                          std::ostream& os);
+
+/// Repeat the bench positions, single-threaded, for a number of rounds and
+/// print one raw NPS sample per round ("sample <round> nodes <n> time <secs>
+/// nps <nps>") followed by the mean and standard deviation. Every round
+/// searches the same tree, so samples differ only by machine noise; compare
+/// builds with scripts/bench (speedtest subcommand). Returns the samples.
+std::vector<BenchResult> speedtest(const BenchConfig& config, int rounds, std::ostream& os);
+
+/// Parse "[depth] [rounds] [hash] [evaltype]" and run speedtest().
+std::vector<BenchResult> speedtest_command(const std::vector<std::string>& args,
+                                           NNUEEvaluator* nnue,
+                                           std::ostream& os);
+
+#endif /* BENCH_H */
@@ -13,6 +13,7 @@
 #include "MoveGenerator.h"
 #include "MoveList.h"
 #include "NNUEEvaluator.h"
+#include "Trace.h"
 
 // Count number of bits set to 1 in 64 bit word
 int pop_count(U64 x)
@@ -39,77 +40,115 @@ Board::Board()
 
 bool Board::is_blank()
 {
-    return !(bitboards_[WHITE] | bitboards_[BLACK]);
+    return !(pos_.bitboards[WHITE] | pos_.bitboards[BLACK]);
 }
 
 void Board::add_piece(U8 piece, int square)
 {
     assert(is_valid_piece(piece));
     assert(is_valid_square(square));
-    assert(board_array_[square] == EMPTY);
-    board_array_[square] = piece;
+    assert(pos_.board_array[square] == EMPTY);
+    pos_.board_array[square] = piece;
     U64 bitboard = 1ULL << square;
-    bitboards_[piece & 1] |= bitboard;
-    bitboards_[piece] |= bitboard;
-    irrev_.board_hash ^= Zobrist::get_pieces(piece, square);
+    pos_.bitboards[piece & 1] |= bitboard;
+    pos_.bitboards[piece] |= bitboard;
+    pos_.state.hash ^= Zobrist::get_pieces(piece, square);
 }
 
 void Board::remove_piece(int square)
 {
     assert(is_valid_square(square));
-    assert(board_array_[square] != EMPTY);
-    U8 piece = board_array_[square];
-    board_array_[square] = EMPTY;
+    assert(pos_.board_array[square] != EMPTY);
+    U8 piece = pos_.board_array[square];
+    pos_.board_array[square] = EMPTY;
     U64 bitboard = ~(1ULL << square);
-    bitboards_[piece & 1] &= bitboard;
-    bitboards_[piece] &= bitboard;
-    irrev_.board_hash ^= Zobrist::get_pieces(piece, square);
+    pos_.bitboards[piece & 1] &= bitboard;
+    pos_.bitboards[piece] &= bitboard;
+    pos_.state.hash ^= Zobrist::get_pieces(piece, square);
 }
 
 void Board::reset()
 {
     Zobrist::init();
     MoveGenerator::init_magic_tables();
+    MoveGenerator::init_slider_backend();
     if (!tt_)
     {
         tt_ = std::make_shared<TranspositionTable>();
     }
     for (int i = 0; i < 64; i++)
     {
-        board_array_[i] = EMPTY;
+        pos_.board_array[i] = EMPTY;
     }
     for (int i = 0; i < 14; i++)
     {
-        bitboards_[i] = BB_EMPTY;
+        pos_.bitboards[i] = BB_EMPTY;
     }
-    irrev_.half_move_count = 0;
-    irrev_.full_move_count = 1;
-    irrev_.castling_rights = FULL_CASTLING_RIGHTS;
-    irrev_.ep_square = NULL_SQUARE;
-    irrev_.side_to_move = WHITE;
+    pos_.state.half_move_count = 0;
+    pos_.state.full_move_count = 1;
+    pos_.state.castling_rights = FULL_CASTLING_RIGHTS;
+    pos_.state.ep_square = NULL_SQUARE;
+    pos_.state.side_to_move = WHITE;
     game_ply_ = 0;
     search_ply_ = 0;
     max_search_ply_ = 0;
     update_hash();
 }
 
+void Board::set_position(const Position& pos)
+{
+    pos_ = pos;
+    game_ply_ = 0;
+    search_ply_ = 0;
+    max_search_ply_ = 0;
+#ifdef EXPENSIVE_ASSERTS
+    assert(pos_.state.hash == Zobrist::get_zobrist_key(*this));
+#endif
+    hash_history_[game_ply_] = pos_.state.hash;
+    if (nnue_)
+    {
+        nnue_->refresh(*this);
+    }
+}
+
+void Board::set_epd_op(const std::string& opcode, const std::string& operand)
+{
+    if (!epd_ || epd_.use_count() > 1)
+    {
+        epd_ = epd_ ? std::make_shared<std::map<std::string, std::string>>(*epd_)
+                    : std::make_shared<std::map<std::string, std::string>>();
+    }
+    (*epd_)[opcode] = operand;
+}
+
+std::string Board::epd_op(const std::string& opcode) const
+{
+    if (!epd_)
+    {
+        return "";
+    }
+    auto it = epd_->find(opcode);
+    return it == epd_->end() ? "" : it->second;
+}
+
 U8 Board::operator[](const int square) const
 {
     assert(is_valid_square(square));
-    return board_array_[square];
+    return pos_.board_array[square];
 }
 
 U64 Board::bitboard(const int type) const
 {
     assert(type >= 0 && type <= BLACK_KING);
-    return bitboards_[type];
+    return pos_.bitboards[type];
 }
 
 void Board::do_move(Move_t move)
 {
+    TRACE_SCOPE(TR_DO_MOVE);
     U8 from = move_from(move);
     U8 to = move_to(move);
-    U8 piece = board_array_[from];
+    U8 piece = pos_.board_array[from];
     bool move_resets_half_move_clock = false;
 
     // Save NNUE accumulator state before making the move
@@ -122,24 +161,24 @@ void Board::do_move(Move_t move)
     // cout << "do_move: move_flag=" << hex << move << endl;
 
     // Save irreversible state
-    move_stack_[search_ply_] = irrev_;
+    move_stack_[search_ply_] = pos_.state;
 
-    if (irrev_.ep_square != NULL_SQUARE)
+    if (pos_.state.ep_square != NULL_SQUARE)
     {
-        irrev_.board_hash ^= Zobrist::get_ep_square(irrev_.ep_square);
+        pos_.state.hash ^= Zobrist::get_ep_square(pos_.state.ep_square);
     }
-    irrev_.ep_square = NULL_SQUARE;
+    pos_.state.ep_square = NULL_SQUARE;
     if (is_pawn_double_push(move))
     {
-        irrev_.ep_square = static_cast<U8>((to + from) >> 1);
-        irrev_.board_hash ^= Zobrist::get_ep_square(irrev_.ep_square);
+        pos_.state.ep_square = static_cast<U8>((to + from) >> 1);
+        pos_.state.hash ^= Zobrist::get_ep_square(pos_.state.ep_square);
     }
 
     if (is_castle(move))
     {
         if (move & build_castle(QUEEN_CASTLE))
         {
-            if (irrev_.side_to_move == WHITE)
+            if (pos_.state.side_to_move == WHITE)
             {
                 // White queen-side castle
                 remove_piece(A1);
@@ -158,7 +197,7 @@ void Board::do_move(Move_t move)
         }
         else
         {
-            if (irrev_.side_to_move == WHITE)
+            if (pos_.state.side_to_move == WHITE)
             {
                 // White king-side castle
                 remove_piece(H1);
@@ -211,45 +250,45 @@ void Board::do_move(Move_t move)
     }
 
     // Update castling rights
-    if (irrev_.castling_rights)
+    if (pos_.state.castling_rights)
     {
-        irrev_.board_hash ^= Zobrist::get_castling_rights(irrev_.castling_rights);
-        if ((board_array_[A1] != WHITE_ROOK) || (board_array_[E1] != WHITE_KING))
+        pos_.state.hash ^= Zobrist::get_castling_rights(pos_.state.castling_rights);
+        if ((pos_.board_array[A1] != WHITE_ROOK) || (pos_.board_array[E1] != WHITE_KING))
         {
-            irrev_.castling_rights &= static_cast<U8>(~(WHITE_QUEEN_SIDE));
+            pos_.state.castling_rights &= static_cast<U8>(~(WHITE_QUEEN_SIDE));
         }
-        if ((board_array_[H1] != WHITE_ROOK) || (board_array_[E1] != WHITE_KING))
+        if ((pos_.board_array[H1] != WHITE_ROOK) || (pos_.board_array[E1] != WHITE_KING))
         {
-            irrev_.castling_rights &= static_cast<U8>(~(WHITE_KING_SIDE));
+            pos_.state.castling_rights &= static_cast<U8>(~(WHITE_KING_SIDE));
         }
-        if ((board_array_[A8] != BLACK_ROOK) || (board_array_[E8] != BLACK_KING))
+        if ((pos_.board_array[A8] != BLACK_ROOK) || (pos_.board_array[E8] != BLACK_KING))
         {
-            irrev_.castling_rights &= static_cast<U8>(~(BLACK_QUEEN_SIDE));
+            pos_.state.castling_rights &= static_cast<U8>(~(BLACK_QUEEN_SIDE));
         }
-        if ((board_array_[H8] != BLACK_ROOK) || (board_array_[E8] != BLACK_KING))
+        if ((pos_.board_array[H8] != BLACK_ROOK) || (pos_.board_array[E8] != BLACK_KING))
         {
-            irrev_.castling_rights &= static_cast<U8>(~(BLACK_KING_SIDE));
+            pos_.state.castling_rights &= static_cast<U8>(~(BLACK_KING_SIDE));
         }
-        irrev_.board_hash ^= Zobrist::get_castling_rights(irrev_.castling_rights);
+        pos_.state.hash ^= Zobrist::get_castling_rights(pos_.state.castling_rights);
     }
 
     // update flags
     if (move_resets_half_move_clock)
     {
-        irrev_.half_move_count = 0;
+        pos_.state.half_move_count = 0;
     }
     else
     {
-        irrev_.half_move_count++;
+        pos_.state.half_move_count++;
     }
-    if (irrev_.side_to_move == BLACK)
+    if (pos_.state.side_to_move == BLACK)
     {
-        irrev_.full_move_count++;
+        pos_.state.full_move_count++;
     }
 
     // update side_to_move
-    irrev_.side_to_move ^= 1;
-    irrev_.board_hash ^= Zobrist::get_side();
+    pos_.state.side_to_move ^= 1;
+    pos_.state.hash ^= Zobrist::get_side();
 
     game_ply_++;
     search_ply_++;
@@ -257,9 +296,9 @@ void Board::do_move(Move_t move)
     // update_hash();
     assert(game_ply_ < MAX_GAME_PLY);
 #ifdef EXPENSIVE_ASSERTS
-    assert(irrev_.board_hash == Zobrist::get_zobrist_key(*this));
+    assert(pos_.state.hash == Zobrist::get_zobrist_key(*this));
 #endif
-    hash_history_[game_ply_] = irrev_.board_hash;
+    hash_history_[game_ply_] = pos_.state.hash;
 
     // Refresh NNUE accumulator from the final board state
     if (nnue_)
@@ -270,9 +309,10 @@ void Board::do_move(Move_t move)
 
 void Board::undo_move(Move_t move)
 {
+    TRACE_SCOPE(TR_UNDO_MOVE);
     U8 from = move_from(move);
     U8 to = move_to(move);
-    U8 piece = board_array_[to];
+    U8 piece = pos_.board_array[to];
     U64 hash;
     // cout << "undo_move:" << Output::move(move, *this) << endl;
     // cout << "undo_move: move_flag=" << hex << move << endl;
@@ -287,14 +327,14 @@ void Board::undo_move(Move_t move)
     search_ply_--;
 
     // update irreversible state
-    irrev_ = move_stack_[search_ply_];
-    hash = irrev_.board_hash;
+    pos_.state = move_stack_[search_ply_];
+    hash = pos_.state.hash;
 
     if (is_castle(move))
     {
         if (move & build_castle(QUEEN_CASTLE))
         {
-            if (irrev_.side_to_move == WHITE)
+            if (pos_.state.side_to_move == WHITE)
             {
                 remove_piece(C1);
                 remove_piece(D1);
@@ -311,7 +351,7 @@ void Board::undo_move(Move_t move)
         }
         else
         {
-            if (irrev_.side_to_move == WHITE)
+            if (pos_.state.side_to_move == WHITE)
             {
                 remove_piece(G1);
                 remove_piece(F1);
@@ -333,7 +373,7 @@ void Board::undo_move(Move_t move)
 
         if (is_promotion(move))
         {
-            add_piece(PAWN | irrev_.side_to_move, from);
+            add_piece(PAWN | pos_.state.side_to_move, from);
         }
         else
         {
@@ -352,7 +392,7 @@ void Board::undo_move(Move_t move)
             add_piece(move_captured(move), captured_sq);
         }
     }
-    irrev_.board_hash = hash;
+    pos_.state.hash = hash;
 }
 
 void Board::do_null_move()
@@ -364,32 +404,32 @@ void Board::do_null_move()
     }
 
     // Save irreversible state
-    move_stack_[search_ply_] = irrev_;
+    move_stack_[search_ply_] = pos_.state;
 
-    if (irrev_.ep_square != NULL_SQUARE)
+    if (pos_.state.ep_square != NULL_SQUARE)
     {
-        irrev_.board_hash ^= Zobrist::get_ep_square(irrev_.ep_square);
+        pos_.state.hash ^= Zobrist::get_ep_square(pos_.state.ep_square);
     }
-    irrev_.ep_square = NULL_SQUARE;
+    pos_.state.ep_square = NULL_SQUARE;
 
-    irrev_.half_move_count++;
-    if (irrev_.side_to_move == BLACK)
+    pos_.state.half_move_count++;
+    if (pos_.state.side_to_move == BLACK)
     {
-        irrev_.full_move_count++;
+        pos_.state.full_move_count++;
     }
 
     // update side_to_move
-    irrev_.side_to_move ^= 1;
-    irrev_.board_hash ^= Zobrist::get_side();
+    pos_.state.side_to_move ^= 1;
+    pos_.state.hash ^= Zobrist::get_side();
 
     game_ply_++;
     search_ply_++;
     max_search_ply_ = std::max(max_search_ply_, search_ply_);
     assert(game_ply_ < MAX_GAME_PLY);
 #ifdef EXPENSIVE_ASSERTS
-    assert(irrev_.board_hash == Zobrist::get_zobrist_key(*this));
+    assert(pos_.state.hash == Zobrist::get_zobrist_key(*this));
 #endif
-    hash_history_[game_ply_] = irrev_.board_hash;
+    hash_history_[game_ply_] = pos_.state.hash;
 }
 
 void Board::undo_null_move()
@@ -404,7 +444,7 @@ void Board::undo_null_move()
     search_ply_--;
 
     // update irreversible state
-    irrev_ = move_stack_[search_ply_];
+    pos_.state = move_stack_[search_ply_];
 }
 
 // is_game_over(): return 1 if game is over.
@@ -424,16 +464,22 @@ bool Board::is_game_over()
 bool Board::is_draw(bool in_search)
 {
     // fifty-move rule
-    if (irrev_.half_move_count >= 100)
+    if (pos_.state.half_move_count >= 100)
     {
         return true;
     }
 
+    // A position can only repeat after two reversible moves by each side
+    if (pos_.state.half_move_count < 4)
+    {
+        return false;
+    }
+
     // Repetition detection: only need to scan back to the last irreversible
     // move (half_move_count positions ago). Step by 2 since only same-side
     // positions can repeat.
     int repetition_count = 0;
-    int start = game_ply_ - irrev_.half_move_count;
+    int start = game_ply_ - pos_.state.half_move_count;
     if (start < 0)
     {
         start = 0;
@@ -446,7 +492,7 @@ bool Board::is_draw(bool in_search)
     }
     for (int i = start; i < game_ply_; i += 2)
     {
-        if (irrev_.board_hash == hash_history_[i])
+        if (pos_.state.hash == hash_history_[i])
         {
             repetition_count++;
         }
@@ -454,9 +500,38 @@ bool Board::is_draw(bool in_search)
     return repetition_count > (in_search ? 0 : 1);
 }
 
+bool Board::has_game_cycle() const
+{
+    int end = std::min(static_cast<int>(pos_.state.half_move_count), game_ply_);
+    if (end < 3)
+    {
+        return false;
+    }
+    U64 occupied = pos_.bitboards[WHITE] | pos_.bitboards[BLACK];
+    // Positions an odd number of plies back had the other side to move: one
+    // of our moves can lead to them
+    for (int i = 3; i <= end; i += 2)
+    {
+        U64 move_key = pos_.state.hash ^ hash_history_[game_ply_ - i];
+        U8 sq1, sq2;
+        if (!Zobrist::find_cuckoo_move(move_key, sq1, sq2))
+        {
+            continue;
+        }
+        // The squares are in either order: the piece is on one of them
+        U8 piece = pos_.board_array[sq1] != EMPTY ? pos_.board_array[sq1] : pos_.board_array[sq2];
+        if (piece != EMPTY && (piece & 1) == pos_.state.side_to_move
+            && !(squares_between(sq1, sq2) & occupied))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 void Board::update_hash()
 {
     assert(game_ply_ < MAX_GAME_PLY);
     set_hash(Zobrist::get_zobrist_key(*this));
-    hash_history_[game_ply_] = irrev_.board_hash;
+    hash_history_[game_ply_] = pos_.state.hash;
 }
@@ -12,6 +12,7 @@
 
 #include "Common.h"
 #include "Move.h"
+#include "Position.h"
 #include "NNUEEvaluator.h"
 #include "Zobrist.h"
 #include "TranspositionTable.h"
@@ -29,22 +30,12 @@ class Board
     friend class Tests;
 
 private:
-    U64 bitboards_[14];
-    U8 board_array_[64];
-
-    struct IrreversibleData
-    {
-        int full_move_count;
-        int half_move_count;
-        U8 castling_rights;
-        U8 ep_square;
-        U8 side_to_move;
-        U64 board_hash;
-    } irrev_;
-
-    // Extended Position Description
-    std::map<std::string, std::string> epd_;
+    Position pos_;
 
+    // The TT is shared between copies, and EPD operations are copied on
+    // write. Each copy has its own evaluator: its pawn hash is only
+    // allocated when the copy first evaluates, so copying stays cheap.
+    std::shared_ptr<std::map<std::string, std::string>> epd_;
     std::shared_ptr<TranspositionTable> tt_;
     HandCraftedEvaluator evaluator_;
     NNUEEvaluator* nnue_ = nullptr;
@@ -54,7 +45,7 @@ private:
     int search_ply_;
     int max_search_ply_;
 
-    struct IrreversibleData move_stack_[MAX_SEARCH_PLY];
+    Position::State move_stack_[MAX_SEARCH_PLY];
 
 public:
     Board();
@@ -68,26 +59,35 @@ public:
     void undo_null_move();
     bool is_game_over();
     bool is_draw(bool in_search = false);
+    /// True if the side to move has a reversible move to a position already
+    /// in the game history, so it can at least draw by repetition (is_draw()
+    /// in search counts a single repetition).
+    bool has_game_cycle() const;
 
     U8 operator[](const int square) const; // return piece on that square
     U64 bitboard(const int type) const;
-    int half_move_count() const { return irrev_.half_move_count; };
-    int full_move_count() const { return irrev_.full_move_count; };
-    U8 castling_rights() const { return irrev_.castling_rights; };
-    U8 ep_square()       const { return irrev_.ep_square; };
-    U8 side_to_move()    const { return irrev_.side_to_move; };
-    U64 get_hash()       const { return irrev_.board_hash; };
-    void set_side_to_move(U8 side) { irrev_.side_to_move = side; };
-    void set_castling_rights(U8 rights) { irrev_.castling_rights = rights; };
-    void set_ep_square(U8 square) { irrev_.ep_square = square; };
-    void set_half_move_count(int count) { irrev_.half_move_count = count; };
-    void set_full_move_count(int count) { irrev_.full_move_count = count; };
-    void set_hash(U64 hash) { irrev_.board_hash = hash; };
+    int half_move_count() const { return pos_.state.half_move_count; };
+    int full_move_count() const { return pos_.state.full_move_count; };
+    U8 castling_rights() const { return pos_.state.castling_rights; };
+    U8 ep_square()       const { return pos_.state.ep_square; };
+    U8 side_to_move()    const { return pos_.state.side_to_move; };
+    U64 get_hash()       const { return pos_.state.hash; };
+    void set_side_to_move(U8 side) { pos_.state.side_to_move = side; };
+    void set_castling_rights(U8 rights) { pos_.state.castling_rights = rights; };
+    void set_ep_square(U8 square) { pos_.state.ep_square = square; };
+    void set_half_move_count(int count) { pos_.state.half_move_count = static_cast<U16>(count); };
+    void set_full_move_count(int count) { pos_.state.full_move_count = static_cast<U16>(count); };
+    void set_hash(U64 hash) { pos_.state.hash = hash; };
     int get_game_ply() const { return game_ply_; };
     int get_search_ply() const { return search_ply_; }
     void set_search_ply(int ply) { search_ply_ = ply; }
     U64 get_hash_history(const int i) const { return hash_history_[i]; }
 
+    const Position& position() const { return pos_; }
+    /// Replace the position and start a new game from it: the history is
+    /// cleared, the TT and evaluators are kept.
+    void set_position(const Position& pos);
+
     void update_hash();
     TranspositionTable& get_tt() { return *tt_; }
     Evaluator& get_evaluator()
@@ -100,8 +100,9 @@ public:
     NNUEEvaluator* get_nnue() const { return nnue_; }
 
     // EPD
-    void set_epd_op(const std::string& opcode, const std::string& operand) { epd_[opcode] = operand; }
-    std::string& epd_op(const std::string& opcode) {return epd_[opcode]; }
+    void set_epd_op(const std::string& opcode, const std::string& operand);
+    /// Operand of an EPD opcode, or an empty string.
+    std::string epd_op(const std::string& opcode) const;
 };
 
 #endif /* BOARD_H */
\ No newline at end of file
@@ -0,0 +1,513 @@
+/*
+ * File:   ChildPosition.cpp
+ *
+ */
+
+#include "ChildPosition.h"
+
+#include "Board.h"
+#include "MoveGenerator.h"
+
+// Indices into ChildPosition::pieces[]
+constexpr int PAWN_TYPE = 0;
+constexpr int KNIGHT_TYPE = 1;
+constexpr int BISHOP_TYPE = 2;
+constexpr int ROOK_TYPE = 3;
+constexpr int QUEEN_TYPE = 4;
+constexpr int KING_TYPE = 5;
+
+// Castling rights left after a move from or to each square
+struct CastlingKept
+{
+    U8 mask[NUM_SQUARES];
+
+    constexpr CastlingKept()
+        : mask()
+    {
+        for (int sq = 0; sq < NUM_SQUARES; sq++)
+        {
+            mask[sq] = FULL_CASTLING_RIGHTS;
+        }
+        mask[A1] = static_cast<U8>(FULL_CASTLING_RIGHTS & ~WHITE_QUEEN_SIDE);
+        mask[H1] = static_cast<U8>(FULL_CASTLING_RIGHTS & ~WHITE_KING_SIDE);
+        mask[E1] = static_cast<U8>(FULL_CASTLING_RIGHTS & ~(WHITE_KING_SIDE | WHITE_QUEEN_SIDE));
+        mask[A8] = static_cast<U8>(FULL_CASTLING_RIGHTS & ~BLACK_QUEEN_SIDE);
+        mask[H8] = static_cast<U8>(FULL_CASTLING_RIGHTS & ~BLACK_KING_SIDE);
+        mask[E8] = static_cast<U8>(FULL_CASTLING_RIGHTS & ~(BLACK_KING_SIDE | BLACK_QUEEN_SIDE));
+    }
+};
+static constexpr CastlingKept CASTLING_KEPT;
+
+// Squares attacked by the pawns of side
+static inline U64 pawn_attacks(U64 pawns, U8 side)
+{
+    if (side == WHITE)
+    {
+        return ((pawns & ~FILE_A) << 7) | ((pawns & ~FILE_H) << 9);
+    }
+    return ((pawns & ~FILE_H) >> 7) | ((pawns & ~FILE_A) >> 9);
+}
+
+ChildPosition ChildPosition::from_board(const Board& board)
+{
+    ChildPosition pos {};
+    for (U8 piece = WHITE_PAWN; piece <= BLACK_KING; piece++)
+    {
+        pos.pieces[piece_type(piece)] |= board.bitboard(piece);
+    }
+    pos.white = board.bitboard(WHITE);
+    pos.side_to_move = board.side_to_move();
+    pos.castling_rights = board.castling_rights();
+    pos.ep_square = board.ep_square();
+    return pos;
+}
+
+U8 ChildPosition::operator[](int square) const
+{
+    U64 bb = 1ULL << square;
+    for (int type = 0; type < 6; type++)
+    {
+        if (pieces[type] & bb)
+        {
+            return static_cast<U8>(((type + 1) << 1) | ((white & bb) ? WHITE : BLACK));
+        }
+    }
+    return EMPTY;
+}
+
+U64 ChildPosition::attackers(int square, U8 by_side) const
+{
+    U64 occ = occupied();
+    U64 by = by_side == WHITE ? white : occ & ~white;
+    U64 queens = pieces[QUEEN_TYPE];
+    return ((pawn_attacks(1ULL << square, by_side ^ 1) & pieces[PAWN_TYPE])
+            | (KNIGHT_LOOKUP_TABLE[square] & pieces[KNIGHT_TYPE])
+            | (KING_LOOKUP_TABLE[square] & pieces[KING_TYPE])
+            | (MoveGenerator::bishop_attacks(occ, square) & (pieces[BISHOP_TYPE] | queens))
+            | (MoveGenerator::rook_attacks(occ, square) & (pieces[ROOK_TYPE] | queens)))
+           & by;
+}
+
+bool ChildPosition::is_attacked(int square, U8 by_side, U64 occ) const
+{
+    U64 by = (by_side == WHITE ? white : ~white) & occ;
+    U64 queens = pieces[QUEEN_TYPE];
+    return (pawn_attacks(1ULL << square, by_side ^ 1) & pieces[PAWN_TYPE] & by)
+           || (KNIGHT_LOOKUP_TABLE[square] & pieces[KNIGHT_TYPE] & by)
+           || (KING_LOOKUP_TABLE[square] & pieces[KING_TYPE] & by)
+           || (MoveGenerator::bishop_attacks(occ, square) & (pieces[BISHOP_TYPE] | queens) & by)
+           || (MoveGenerator::rook_attacks(occ, square) & (pieces[ROOK_TYPE] | queens) & by);
+}
+
+bool ChildPosition::in_check() const
+{
+    U8 king_sq = bit_scan_forward(pieces[KING_TYPE] & color(side_to_move));
+    return is_attacked(king_sq, side_to_move ^ 1);
+}
+
+// What makes a move of the side to move legal: non-king moves must land on
+// evasions (every square unless in check) and pinned pieces must stay on
+// the line through their king.
+struct LegalMasks
+{
+    U64 own;
+    U64 enemy;
+    U64 evasions;
+    U64 pinned;
+    U8 king_sq;
+    bool in_check;
+};
+
+static LegalMasks legal_masks(const ChildPosition& pos)
+{
+    LegalMasks m;
+    U8 us = pos.side_to_move;
+    U64 occ = pos.occupied();
+    m.own = pos.color(us);
+    m.enemy = occ & ~m.own;
+    m.king_sq = bit_scan_forward(pos.pieces[KING_TYPE] & m.own);
+
+    U64 checkers = pos.attackers(m.king_sq, us ^ 1);
+    m.in_check = checkers != BB_EMPTY;
+    m.evasions = ~BB_EMPTY;
+    if (m.in_check)
+    {
+        // Capture or block a single checker; only the king moves out of a double check
+        m.evasions = (checkers & (checkers - 1))
+                         ? BB_EMPTY
+                         : checkers | squares_between(m.king_sq, bit_scan_forward(checkers));
+    }
+
+    // Own pieces alone between the king and an enemy slider
+    m.pinned = BB_EMPTY;
+    U64 queens = pos.pieces[QUEEN_TYPE];
+    U64 snipers = ((MoveGenerator::rook_attacks(BB_EMPTY, m.king_sq)
+                    & (pos.pieces[ROOK_TYPE] | queens))
+                   | (MoveGenerator::bishop_attacks(BB_EMPTY, m.king_sq)
+                      & (pos.pieces[BISHOP_TYPE] | queens)))
+                  & m.enemy;
+    while (snipers)
+    {
+        U64 between = squares_between(m.king_sq, bit_scan_forward(snipers)) & occ;
+        if (between && !(between & (between - 1)) && (between & m.own))
+        {
+            m.pinned |= between;
+        }
+        snipers &= snipers - 1;
+    }
+    return m;
+}
+
+static U64 slider_attacks(int type, U64 occ, int square)
+{
+    switch (type)
+    {
+        case BISHOP_TYPE:
+            return MoveGenerator::bishop_attacks(occ, square);
+        case ROOK_TYPE:
+            return MoveGenerator::rook_attacks(occ, square);
+        default:
+            return MoveGenerator::bishop_attacks(occ, square)
+                | MoveGenerator::rook_attacks(occ, square);
+    }
+}
+
+// Pawn move targets, one bitboard per direction so that two pawns
+// capturing on the same square are two moves
+struct PawnTargets
+{
+    U64 push;
+    U64 double_push;
+    U64 capture_left;
+    U64 capture_right;
+    int diff;  // to - from of a push; the captures are diff -/+ 1
+};
+
+static PawnTargets pawn_targets(U64 pawns, U8 us, U64 occ, U64 enemy)
+{
+    PawnTargets t;
+    U64 empty = ~occ;
+    if (us == WHITE)
+    {
+        t.push = (pawns << 8) & empty;
+        t.double_push = ((t.push & ROW_3) << 8) & empty;
+        t.capture_left = ((pawns & ~FILE_A) << 7) & enemy;
+        t.capture_right = ((pawns & ~FILE_H) << 9) & enemy;
+        t.diff = 8;
+    }
+    else
+    {
+        t.push = (pawns >> 8) & empty;
+        t.double_push = ((t.push & ROW_6) >> 8) & empty;
+        t.capture_left = ((pawns & ~FILE_A) >> 9) & enemy;
+        t.capture_right = ((pawns & ~FILE_H) >> 7) & enemy;
+        t.diff = -8;
+    }
+    return t;
+}
+
+// En passant is legal if the king is not attacked once both pawns are gone
+// from their squares (this also catches the rank pin of the two pawns).
+static bool ep_is_legal(const ChildPosition& pos, const LegalMasks& m, U8 from)
+{
+    U8 to = pos.ep_square;
+    U8 captured_sq = static_cast<U8>((from & 56) | (to & 7));
+    U64 occ = ((m.own | m.enemy) ^ (1ULL << from) ^ (1ULL << captured_sq)) | (1ULL << to);
+    return !pos.is_attacked(m.king_sq, pos.side_to_move ^ 1, occ);
+}
+
+// Legal castles of the side to move: the king is not in check and does not
+// cross or land on an attacked square
+static U32 legal_castles(const ChildPosition& pos, const LegalMasks& m)
+{
+    U8 us = pos.side_to_move;
+    U8 them = us ^ 1;
+    U8 king_side = (us == WHITE) ? WHITE_KING_SIDE : BLACK_KING_SIDE;
+    U8 queen_side = (us == WHITE) ? WHITE_QUEEN_SIDE : BLACK_QUEEN_SIDE;
+    if (m.in_check || !(pos.castling_rights & (king_side | queen_side)))
+    {
+        return NO_FLAGS;
+    }
+
+    int rank = (us == WHITE) ? 0 : A8;
+    U64 occ = m.own | m.enemy;
+    U32 castles = NO_FLAGS;
+    if ((pos.castling_rights & king_side)
+        && !(occ & ((1ULL << (F1 + rank)) | (1ULL << (G1 + rank))))
+        && !pos.is_attacked(F1 + rank, them) && !pos.is_attacked(G1 + rank, them))
+    {
+        castles |= KING_CASTLE;
+    }
+    if ((pos.castling_rights & queen_side)
+        && !(occ & ((1ULL << (B1 + rank)) | (1ULL << (C1 + rank)) | (1ULL << (D1 + rank))))
+        && !pos.is_attacked(D1 + rank, them) && !pos.is_attacked(C1 + rank, them))
+    {
+        castles |= QUEEN_CASTLE;
+    }
+    return castles;
+}
+
+// Safe king targets: the king is removed first so it cannot hide behind
+// itself from a slider
+static U64 king_targets(const ChildPosition& pos, const LegalMasks& m)
+{
+    U64 targets = KING_LOOKUP_TABLE[m.king_sq] & ~m.own;
+    U64 occ = (m.own | m.enemy) ^ (1ULL << m.king_sq);
+    U64 safe = BB_EMPTY;
+    while (targets)
+    {
+        U8 to = bit_scan_forward(targets);
+        if (!pos.is_attacked(to, pos.side_to_move ^ 1, occ))
+        {
+            safe |= 1ULL << to;
+        }
+        targets &= targets - 1;
+    }
+    return safe;
+}
+
+// The one legal move walker behind ChildIterator and count_children(). It
+// hands the sink each group of legal moves:
+//   add_targets(from, targets, type)   moves of one piece to a target set
+//   add_pawn_moves(targets, diff, flags) pawn moves to targets, from = to - diff
+//   add_castle(castle)                 KING_CASTLE or QUEEN_CASTLE
+//   add_ep(from)                       an en passant capture from a square
+template<typename Sink>
+void ChildIterator::generate(const ChildPosition& pos, Sink& sink)
+{
+    LegalMasks m = legal_masks(pos);
+    U8 us = pos.side_to_move;
+    U64 occ = m.own | m.enemy;
+
+    sink.add_targets(m.king_sq, king_targets(pos, m), KING_TYPE);
+    if (!m.evasions)
+    {
+        return;  // double check
+    }
+    U32 castles = legal_castles(pos, m);
+    if (castles & KING_CASTLE)
+    {
+        sink.add_castle(KING_CASTLE);
+    }
+    if (castles & QUEEN_CASTLE)
+    {
+        sink.add_castle(QUEEN_CASTLE);
+    }
+
+    // Pinned pieces move one at a time, restricted to their pin line
+    U64 pawns = pos.pieces[PAWN_TYPE] & m.own;
+    for (U64 pinned = pawns & m.pinned; pinned; pinned &= pinned - 1)
+    {
+        U8 from = bit_scan_forward(pinned);
+        U64 allowed = m.evasions & lines_along(m.king_sq, from);
+        PawnTargets t = pawn_targets(1ULL << from, us, occ, m.enemy);
+        sink.add_pawn_moves(t.push & allowed, t.diff, NO_FLAGS);
+        sink.add_pawn_moves(t.double_push & allowed, 2 * t.diff, PAWN_DOUBLE_PUSH);
+        sink.add_pawn_moves(t.capture_left & allowed, t.diff - 1, NO_FLAGS);
+        sink.add_pawn_moves(t.capture_right & allowed, t.diff + 1, NO_FLAGS);
+    }
+    PawnTargets t = pawn_targets(pawns & ~m.pinned, us, occ, m.enemy);
+    sink.add_pawn_moves(t.push & m.evasions, t.diff, NO_FLAGS);
+    sink.add_pawn_moves(t.double_push & m.evasions, 2 * t.diff, PAWN_DOUBLE_PUSH);
+    sink.add_pawn_moves(t.capture_left & m.evasions, t.diff - 1, NO_FLAGS);
+    sink.add_pawn_moves(t.capture_right & m.evasions, t.diff + 1, NO_FLAGS);
+    if (pos.ep_square != NULL_SQUARE)
+    {
+        for (U64 from = pawn_attacks(1ULL << pos.ep_square, us ^ 1) & pawns; from;
+             from &= from - 1)
+        {
+            if (ep_is_legal(pos, m, bit_scan_forward(from)))
+            {
+                sink.add_ep(bit_scan_forward(from));
+            }
+        }
+    }
+
+    // Pinned knights never move
+    U64 targets = ~m.own & m.evasions;
+    for (U64 knights = pos.pieces[KNIGHT_TYPE] & m.own & ~m.pinned; knights;
+         knights &= knights - 1)
+    {
+        U8 from = bit_scan_forward(knights);
+        sink.add_targets(from, KNIGHT_LOOKUP_TABLE[from] & targets, KNIGHT_TYPE);
+    }
+    for (int type = BISHOP_TYPE; type <= QUEEN_TYPE; type++)
+    {
+        for (U64 sliders = pos.pieces[type] & m.own; sliders; sliders &= sliders - 1)
+        {
+            U8 from = bit_scan_forward(sliders);
+            U64 to = slider_attacks(type, occ, from) & targets;
+            if (m.pinned & (1ULL << from))
+            {
+                to &= lines_along(m.king_sq, from);
+            }
+            sink.add_targets(from, to, type);
+        }
+    }
+}
+
+ChildIterator::ChildIterator(const ChildPosition& parent)
+    : parent_(parent)
+    , enemy_(parent.occupied() & ~parent.color(parent.side_to_move))
+{
+    generate(parent, *this);
+}
+
+void ChildIterator::add_castle(U32 castle)
+{
+    moves_[size_] = build_castle(castle);
+    types_[size_++] = KING_TYPE;
+}
+
+void ChildIterator::add_ep(U8 from)
+{
+    U8 them = parent_.side_to_move ^ 1;
+    moves_[size_] = build_ep_capture(from, parent_.ep_square, PAWN | them);
+    types_[size_++] = PAWN_TYPE;
+}
+
+void ChildIterator::add(U8 from, U8 to, int type, U32 flags)
+{
+    U8 captured = (enemy_ & (1ULL << to)) ? parent_[to] : EMPTY;
+    moves_[size_] = build_move_all(from, to, captured, flags);
+    types_[size_++] = static_cast<U8>(type);
+}
+
+void ChildIterator::add_targets(U8 from, U64 targets, int type)
+{
+    while (targets)
+    {
+        add(from, bit_scan_forward(targets), type, NO_FLAGS);
+        targets &= targets - 1;
+    }
+}
+
+void ChildIterator::add_pawn_moves(U64 targets, int diff, U32 flags)
+{
+    U8 us = parent_.side_to_move;
+    while (targets)
+    {
+        U8 to = bit_scan_forward(targets);
+        U8 from = static_cast<U8>(to - diff);
+        if ((1ULL << to) & (ROW_1 | ROW_8))
+        {
+            for (U8 promote_to : { KNIGHT, BISHOP, ROOK, QUEEN })
+            {
+                U32 promotion = static_cast<U32>(promote_to | us) << FLAGS_SHIFT;
+                add(from, to, PAWN_TYPE, flags | promotion);
+            }
+        }
+        else
+        {
+            add(from, to, PAWN_TYPE, flags);
+        }
+        targets &= targets - 1;
+    }
+}
+
+void ChildIterator::make(int i, ChildPosition& child) const
+{
+    Move_t move = moves_[i];
+    U8 us = parent_.side_to_move;
+    child = parent_;
+    child.ep_square = NULL_SQUARE;
+    child.side_to_move = us ^ 1;
+
+    if (move.is_castle())
+    {
+        int rank = (us == WHITE) ? 0 : A8;
+        bool queen_side = (move & build_castle(QUEEN_CASTLE)) != 0;
+        U64 king = (1ULL << (E1 + rank)) | (1ULL << ((queen_side ? C1 : G1) + rank));
+        U64 rook = (1ULL << ((queen_side ? A1 : H1) + rank))
+                   | (1ULL << ((queen_side ? D1 : F1) + rank));
+        child.pieces[KING_TYPE] ^= king;
+        child.pieces[ROOK_TYPE] ^= rook;
+        if (us == WHITE)
+        {
+            child.white ^= king | rook;
+        }
+        child.castling_rights &= CASTLING_KEPT.mask[E1 + rank];
+        return;
+    }
+
+    U8 from = move.from();
+    U8 to = move.to();
+    U64 to_bb = 1ULL << to;
+    if (move.is_capture())
+    {
+        U8 captured_sq = move.is_ep_capture() ? static_cast<U8>((from & 56) | (to & 7)) : to;
+        U64 keep = ~(1ULL << captured_sq);
+        child.pieces[ChildPosition::piece_type(move.captured())] &= keep;
+        child.white &= keep;
+    }
+    U64 from_to = (1ULL << from) | to_bb;
+    child.pieces[types_[i]] ^= from_to;
+    if (move.is_promotion())
+    {
+        child.pieces[PAWN_TYPE] ^= to_bb;
+        child.pieces[ChildPosition::piece_type(move.promote_to())] |= to_bb;
+    }
+    if (us == WHITE)
+    {
+        child.white ^= from_to;
+    }
+    if (move.is_pawn_double_push())
+    {
+        child.ep_square = static_cast<U8>((from + to) >> 1);
+    }
+    child.castling_rights &= CASTLING_KEPT.mask[from] & CASTLING_KEPT.mask[to];
+}
+
+bool ChildIterator::next(ChildPosition& child, Move_t& move)
+{
+    if (next_ >= size_)
+    {
+        return false;
+    }
+    make(next_, child);
+    move = moves_[next_++];
+    return true;
+}
+
+// Sink for ChildIterator::generate() that only counts: promotions are four
+// moves each
+struct ChildCounter
+{
+    int n = 0;
+
+    void add_targets(U8, U64 targets, int) { n += pop_count(targets); }
+    void add_pawn_moves(U64 targets, int, U32)
+    {
+        n += pop_count(targets & ~(ROW_1 | ROW_8)) + 4 * pop_count(targets & (ROW_1 | ROW_8));
+    }
+    void add_castle(U32) { n++; }
+    void add_ep(U8) { n++; }
+};
+
+int count_children(const ChildPosition& pos)
+{
+    ChildCounter counter;
+    ChildIterator::generate(pos, counter);
+    return counter.n;
+}
+
+U64 perft_children(const ChildPosition& pos, int depth)
+{
+    if (depth <= 0)
+    {
+        return 1;
+    }
+    if (depth == 1)
+    {
+        return static_cast<U64>(count_children(pos));
+    }
+    U64 nodes = 0;
+    ChildIterator children(pos);
+    ChildPosition child;
+    Move_t move;
+    while (children.next(child, move))
+    {
+        nodes += perft_children(child, depth - 1);
+    }
+    return nodes;
+}
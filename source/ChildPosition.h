@@ -0,0 +1,100 @@
+/*
+ * File:   ChildPosition.h
+ *
+ * Copy-make successor positions for perft and tree building.
+ *
+ * ChildPosition is the bare position in 64 bytes: one bitboard per piece
+ * type (both colours), the white pieces, side to move, castling rights and
+ * en passant square. It has no Zobrist key, evaluator state, board array or
+ * game history, so making a move is a copy and a few bit operations, and
+ * there is nothing to undo. ChildIterator generates the legal moves of a
+ * position and yields each successor together with its move in the Board
+ * encoding; count_children() counts them without generating any.
+ *
+ * Callers that need a hash (repetitions, TT), an evaluation or the
+ * half-move clock keep using Board::do_move().
+ */
+
+#ifndef CHILD_POSITION_H
+#define CHILD_POSITION_H
+
+#include "Common.h"
+#include "Move.h"
+#include "MoveList.h"
+
+class Board;
+
+struct ChildPosition
+{
+    U64 pieces[6];  // PAWN..KING of both colours, indexed by piece_type()
+    U64 white;
+    U8 side_to_move;
+    U8 castling_rights;
+    U8 ep_square;
+    U8 unused[5];
+
+    static ChildPosition from_board(const Board& board);
+
+    /// Index into pieces[] of a piece (colour ignored): PAWN is 0, KING is 5.
+    static int piece_type(U8 piece) { return (piece >> 1) - 1; }
+
+    U64 occupied() const
+    {
+        return pieces[0] | pieces[1] | pieces[2] | pieces[3] | pieces[4] | pieces[5];
+    }
+    U64 color(U8 side) const { return side == WHITE ? white : occupied() & ~white; }
+    U64 bitboard(U8 piece) const { return pieces[piece_type(piece)] & color(piece & 1); }
+    U8 operator[](int square) const;  // piece on square, or EMPTY
+    U64 attackers(int square, U8 by_side) const;
+    bool is_attacked(int square, U8 by_side) const
+    {
+        return is_attacked(square, by_side, occupied());
+    }
+    /// Same, as if only the squares in occ were occupied.
+    bool is_attacked(int square, U8 by_side, U64 occ) const;
+    bool in_check() const;
+};
+static_assert(sizeof(ChildPosition) == 64, "ChildPosition should fit a cache line");
+
+/// Legal successors of a position, made one at a time by copy-make.
+class ChildIterator
+{
+public:
+    explicit ChildIterator(const ChildPosition& parent);
+
+    /// Make the next move into child. Returns false when there are no moves
+    /// left.
+    bool next(ChildPosition& child, Move_t& move);
+
+    int size() const { return size_; }
+
+private:
+    friend int count_children(const ChildPosition& pos);
+
+    /// Walk the legal moves of pos, handing each group of them to sink
+    /// (this iterator, or the counter of count_children()).
+    template<typename Sink>
+    static void generate(const ChildPosition& pos, Sink& sink);
+
+    void add(U8 from, U8 to, int type, U32 flags);
+    void add_targets(U8 from, U64 targets, int type);
+    void add_pawn_moves(U64 targets, int diff, U32 flags);
+    void add_castle(U32 castle);
+    void add_ep(U8 from);
+    void make(int i, ChildPosition& child) const;
+
+    const ChildPosition& parent_;
+    U64 enemy_;
+    int size_ = 0;
+    int next_ = 0;
+    Move_t moves_[MAX_MOVELIST_LENGTH];
+    U8 types_[MAX_MOVELIST_LENGTH];  // piece_type() of the moving piece
+};
+
+/// Number of legal moves in pos (bulk counted: nothing is made).
+int count_children(const ChildPosition& pos);
+
+/// Leaf count of the perft tree below pos, using copy-make children.
+U64 perft_children(const ChildPosition& pos, int depth);
+
+#endif /* CHILD_POSITION_H */
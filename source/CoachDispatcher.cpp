@@ -120,10 +120,12 @@ void CoachDispatcher::cmd_eval(const std::string& args)
         return;
     }
 
-    // Validate and set up position
+    // Validate and set up position. Only the Position is taken from the
+    // parsed board: board_ keeps its TT, evaluator and NNUE.
+    Position pos;
     try
     {
-        board_ = Parser::parse_fen(fen);
+        pos = Parser::parse_fen(fen).position();
     } catch (...)
     {
         send_error("invalid_fen", "Could not parse FEN: '" + fen + "'");
@@ -131,11 +133,12 @@ void CoachDispatcher::cmd_eval(const std::string& args)
     }
 
     // Validate board has both kings (parse_fen doesn't throw on garbage input)
-    if (pop_count(board_.bitboard(WHITE_KING)) != 1 || pop_count(board_.bitboard(BLACK_KING)) != 1)
+    if (pop_count(pos.bitboard(WHITE_KING)) != 1 || pop_count(pos.bitboard(BLACK_KING)) != 1)
     {
         send_error("invalid_fen", "Could not parse FEN: '" + fen + "'");
         return;
     }
+    board_.set_position(pos);
 
     // Set up NNUE if available
     if (nnue_ && nnue_->is_loaded())
@@ -232,10 +235,12 @@ void CoachDispatcher::cmd_compare(const std::string& args)
         return;
     }
 
-    // Validate and set up position
+    // Validate and set up position. Only the Position is taken from the
+    // parsed board: board_ keeps its TT, evaluator and NNUE.
+    Position pos;
     try
     {
-        board_ = Parser::parse_fen(fen);
+        pos = Parser::parse_fen(fen).position();
     } catch (...)
     {
         send_error("invalid_fen", "Could not parse FEN: '" + fen + "'");
@@ -243,11 +248,12 @@ void CoachDispatcher::cmd_compare(const std::string& args)
     }
 
     // Validate board has both kings
-    if (pop_count(board_.bitboard(WHITE_KING)) != 1 || pop_count(board_.bitboard(BLACK_KING)) != 1)
+    if (pop_count(pos.bitboard(WHITE_KING)) != 1 || pop_count(pos.bitboard(BLACK_KING)) != 1)
     {
         send_error("invalid_fen", "Could not parse FEN: '" + fen + "'");
         return;
     }
+    board_.set_position(pos);
 
     // Set up NNUE if available
     if (nnue_ && nnue_->is_loaded())
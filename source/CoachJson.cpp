@@ -4,6 +4,8 @@
  * Lightweight JSON serialization utilities for the Coaching Protocol.
  */
 
+#include <cmath>
+#include <cstdio>
 #include <sstream>
 
 #include "CoachJson.h"
@@ -26,6 +28,17 @@ std::string to_json(bool value)
     return value ? "true" : "false";
 }
 
+std::string to_json(double value)
+{
+    if (!std::isfinite(value))
+    {
+        return to_json_null();
+    }
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.6g", value);
+    return buf;
+}
+
 std::string to_json(const std::string& value)
 {
     std::string result;
@@ -22,6 +22,7 @@ namespace CoachJson {
 // Primitive serializers
 std::string to_json(int value);
 std::string to_json(bool value);
+std::string to_json(double value);              // %.6g, null if not finite
 std::string to_json(const std::string& value);  // escapes ", \, and control characters
 std::string to_json(const char* value);          // delegates to string overload
 std::string to_json_null();
@@ -6,11 +6,13 @@
  */
 
 #include <algorithm>
+#include <cstdlib>
 
 #include "Evaluator.h"
 
 #include "Board.h"
 #include "MoveGenerator.h"
+#include "Trace.h"
 #include "Zobrist.h"
 
 // Phase constants
@@ -121,11 +123,29 @@ static const int PIECE_SQUARE_BONUS[NUM_PHASES][5][8][4] = {
 
 // clang-format on
 
+int HandCraftedEvaluator::piece_square_table_[2][14][64];
+
 HandCraftedEvaluator::HandCraftedEvaluator()
-    : piece_square_table_ {}
-    , config_ {}
+    : config_ {}
+{
+    // Filled once, by the first evaluator (thread-safe static init)
+    static const bool psqt_ready = (psqt_init(), true);
+    (void)psqt_ready;
+}
+
+HandCraftedEvaluator::HandCraftedEvaluator(const HandCraftedEvaluator& other)
+    : pawn_hash_mb_(other.pawn_hash_mb_)
+    , config_(other.config_)
+{
+}
+
+HandCraftedEvaluator& HandCraftedEvaluator::operator=(const HandCraftedEvaluator& other)
 {
-    psqt_init();
+    if (this != &other)
+    {
+        *this = HandCraftedEvaluator(other);
+    }
+    return *this;
 }
 
 void HandCraftedEvaluator::psqt_init()
@@ -176,7 +196,38 @@ int HandCraftedEvaluator::phase(const Board& board) const
     return ((npm - ENDGAME_LIMIT) * PHASE_MAX) / (MIDGAME_LIMIT - ENDGAME_LIMIT);
 }
 
-int HandCraftedEvaluator::eval_pawn_structure(const Board& board, int p)
+void HandCraftedEvaluator::resize_pawn_hash(int size_mb)
+{
+    size_t entries = std::max<size_t>(1, static_cast<size_t>(std::max(1, size_mb)) * 1024 * 1024
+                                             / sizeof(PawnHashEntry));
+    size_t actual = 1;
+    while (actual * 2 <= entries)
+    {
+        actual *= 2;
+    }
+    pawn_hash_ = std::vector<PawnHashEntry>(actual);
+    pawn_hash_mask_ = actual - 1;
+    pawn_hash_mb_ = size_mb;
+}
+
+// Squares on and ahead of the given ones, towards rank 8 / rank 1
+static U64 fill_north(U64 b)
+{
+    b |= b << 8;
+    b |= b << 16;
+    b |= b << 32;
+    return b;
+}
+
+static U64 fill_south(U64 b)
+{
+    b |= b >> 8;
+    b |= b >> 16;
+    b |= b >> 32;
+    return b;
+}
+
+PawnHashEntry& HandCraftedEvaluator::probe_pawns(const Board& board)
 {
     // Compute pawn-only Zobrist hash
     U64 pawn_hash = 0;
@@ -197,180 +248,229 @@ int HandCraftedEvaluator::eval_pawn_structure(const Board& board, int p)
         bp_iter &= bp_iter - 1;
     }
 
-    // Probe pawn hash table
-    int index = static_cast<int>(pawn_hash % PAWN_HASH_SIZE);
-    PawnHashEntry& entry = pawn_hash_[index];
-    int mg_score;
-    int eg_score;
+    if (!config_.pawn_hash_enabled)
+    {
+        compute_pawns(pawn_scratch_, wp, bp);
+        pawn_scratch_.key = pawn_hash;
+        return pawn_scratch_;
+    }
 
-    if (entry.key == pawn_hash && pawn_hash != 0)
+    // Probe pawn hash table
+    if (pawn_hash_.empty())
     {
-        mg_score = entry.mg_score;
-        eg_score = entry.eg_score;
+        resize_pawn_hash(pawn_hash_mb_);
     }
-    else
+    PawnHashEntry& entry = pawn_hash_[pawn_hash & pawn_hash_mask_];
+    if (entry.key != pawn_hash || pawn_hash == 0)
     {
-        mg_score = 0;
-        eg_score = 0;
+        compute_pawns(entry, wp, bp);
+        entry.key = pawn_hash;
+    }
+    return entry;
+}
 
-        // Evaluate for both sides
-        for (int side = 0; side <= 1; side++)
+void HandCraftedEvaluator::compute_pawns(PawnHashEntry& entry, U64 wp, U64 bp)
+{
+    int mg_score = 0;
+    int eg_score = 0;
+
+    // A pawn is passed when no enemy pawn can block it on its file or
+    // capture it from an adjacent file as it advances
+    entry.attack_span[WHITE] = MoveGenerator::pawn_targets(fill_north(wp), WHITE);
+    entry.attack_span[BLACK] = MoveGenerator::pawn_targets(fill_south(bp), BLACK);
+    entry.passed[WHITE] = wp & ~entry.attack_span[BLACK] & ~fill_south(bp >> 8);
+    entry.passed[BLACK] = bp & ~entry.attack_span[WHITE] & ~fill_north(wp << 8);
+
+    // Evaluate for both sides
+    for (int side = 0; side <= 1; side++)
+    {
+        int sign = (side == WHITE) ? 1 : -1;
+        U64 friendly_pawns = (side == WHITE) ? wp : bp;
+        U64 enemy_pawns = (side == WHITE) ? bp : wp;
+        U64 iter = friendly_pawns;
+        U8 isolated_files = 0;
+        U8 doubled_files = 0;
+
+        while (iter)
         {
-            int sign = (side == WHITE) ? 1 : -1;
-            U64 friendly_pawns = (side == WHITE) ? wp : bp;
-            U64 enemy_pawns = (side == WHITE) ? bp : wp;
-            U64 iter = friendly_pawns;
+            int sq = bit_scan_forward(iter);
+            iter &= iter - 1;
 
-            while (iter)
-            {
-                int sq = bit_scan_forward(iter);
-                iter &= iter - 1;
+            int rank = sq / 8;
+            int file = sq % 8;
 
-                int rank = sq / 8;
-                int file = sq % 8;
+            // Rank distance from start: white starts rank 1, black starts rank 6
+            int rank_dist = (side == WHITE) ? (rank - 1) : (6 - rank);
+            // Clamp to valid index [0, 5]
+            rank_dist = std::max(0, std::min(5, rank_dist));
 
-                // Rank distance from start: white starts rank 1, black starts rank 6
-                int rank_dist = (side == WHITE) ? (rank - 1) : (6 - rank);
-                // Clamp to valid index [0, 5]
-                rank_dist = std::max(0, std::min(5, rank_dist));
+            U64 adj = adjacent_files(file);
 
-                U64 adj = adjacent_files(file);
-                U64 file_bb = FILE_BB[file];
+            // --- Passed pawn ---
+            if (entry.passed[side] & (1ULL << sq))
+            {
+                mg_score += sign * PASSED_PAWN_MG[rank_dist];
+                eg_score += sign * PASSED_PAWN_EG[rank_dist];
+            }
 
-                // --- Passed pawn ---
-                // No enemy pawns on same file or adjacent files ahead
-                U64 front_mask;
+            // --- Isolated pawn ---
+            if ((friendly_pawns & adj) == 0)
+            {
+                mg_score += sign * ISOLATED_PAWN_MG;
+                eg_score += sign * ISOLATED_PAWN_EG;
+                isolated_files |= static_cast<U8>(1 << file);
+            }
+
+            // --- Backward pawn ---
+            // A pawn is backward if:
+            // 1. No friendly pawn behind on adjacent files can support it
+            // 2. The stop square is controlled by an enemy pawn
+            if ((friendly_pawns & adj) != 0)
+            {
+                // Only check backward if not isolated (isolated already penalized)
+                U64 behind_mask;
                 if (side == WHITE)
                 {
-                    // Squares ahead of this pawn (higher ranks)
-                    front_mask = 0;
-                    for (int r = rank + 1; r <= 7; r++)
-                        front_mask |= (0xFFULL << (r * 8));
-                }
-                else
-                {
-                    // Squares ahead of this pawn (lower ranks)
-                    front_mask = 0;
+                    behind_mask = 0;
                     for (int r = 0; r < rank; r++)
-                        front_mask |= (0xFFULL << (r * 8));
-                }
-                U64 blocking_files = file_bb | adj;
-                if ((enemy_pawns & blocking_files & front_mask) == 0)
-                {
-                    mg_score += sign * PASSED_PAWN_MG[rank_dist];
-                    eg_score += sign * PASSED_PAWN_EG[rank_dist];
+                        behind_mask |= (0xFFULL << (r * 8));
                 }
-
-                // --- Isolated pawn ---
-                if ((friendly_pawns & adj) == 0)
+                else
                 {
-                    mg_score += sign * ISOLATED_PAWN_MG;
-                    eg_score += sign * ISOLATED_PAWN_EG;
+                    behind_mask = 0;
+                    for (int r = rank + 1; r <= 7; r++)
+                        behind_mask |= (0xFFULL << (r * 8));
                 }
+                bool no_support_behind = ((friendly_pawns & adj & behind_mask) == 0);
 
-                // --- Backward pawn ---
-                // A pawn is backward if:
-                // 1. No friendly pawn behind on adjacent files can support it
-                // 2. The stop square is controlled by an enemy pawn
-                if ((friendly_pawns & adj) != 0)
+                if (no_support_behind)
                 {
-                    // Only check backward if not isolated (isolated already penalized)
-                    U64 behind_mask;
-                    if (side == WHITE)
+                    // Check if stop square is controlled by enemy pawn
+                    int stop_sq = (side == WHITE) ? sq + 8 : sq - 8;
+                    if (stop_sq >= 0 && stop_sq < 64)
                     {
-                        behind_mask = 0;
-                        for (int r = 0; r < rank; r++)
-                            behind_mask |= (0xFFULL << (r * 8));
-                    }
-                    else
-                    {
-                        behind_mask = 0;
-                        for (int r = rank + 1; r <= 7; r++)
-                            behind_mask |= (0xFFULL << (r * 8));
-                    }
-                    bool no_support_behind = ((friendly_pawns & adj & behind_mask) == 0);
-
-                    if (no_support_behind)
-                    {
-                        // Check if stop square is controlled by enemy pawn
-                        int stop_sq = (side == WHITE) ? sq + 8 : sq - 8;
-                        if (stop_sq >= 0 && stop_sq < 64)
+                        // Enemy pawn attacks on the stop square
+                        U64 stop_bb = 1ULL << stop_sq;
+                        U64 enemy_pawn_attacks;
+                        if (side == WHITE)
+                        {
+                            // Black pawns attack diagonally down
+                            enemy_pawn_attacks = ((enemy_pawns >> 7) & ~FILE_BB[0])
+                                | ((enemy_pawns >> 9) & ~FILE_BB[7]);
+                        }
+                        else
                         {
-                            // Enemy pawn attacks on the stop square
-                            U64 stop_bb = 1ULL << stop_sq;
-                            U64 enemy_pawn_attacks;
-                            if (side == WHITE)
-                            {
-                                // Black pawns attack diagonally down
-                                enemy_pawn_attacks = ((enemy_pawns >> 7) & ~FILE_BB[0])
-                                    | ((enemy_pawns >> 9) & ~FILE_BB[7]);
-                            }
-                            else
-                            {
-                                // White pawns attack diagonally up
-                                enemy_pawn_attacks = ((enemy_pawns << 7) & ~FILE_BB[7])
-                                    | ((enemy_pawns << 9) & ~FILE_BB[0]);
-                            }
-                            if (stop_bb & enemy_pawn_attacks)
-                            {
-                                mg_score += sign * BACKWARD_PAWN_MG;
-                                eg_score += sign * BACKWARD_PAWN_EG;
-                            }
+                            // White pawns attack diagonally up
+                            enemy_pawn_attacks = ((enemy_pawns << 7) & ~FILE_BB[7])
+                                | ((enemy_pawns << 9) & ~FILE_BB[0]);
+                        }
+                        if (stop_bb & enemy_pawn_attacks)
+                        {
+                            mg_score += sign * BACKWARD_PAWN_MG;
+                            eg_score += sign * BACKWARD_PAWN_EG;
                         }
                     }
                 }
+            }
 
-                // --- Connected pawn ---
-                // Defended by or adjacent to a friendly pawn
-                U64 pawn_bb = 1ULL << sq;
-                U64 friendly_pawn_attacks;
-                if (side == WHITE)
-                {
-                    friendly_pawn_attacks = ((friendly_pawns << 7) & ~FILE_BB[7])
-                        | ((friendly_pawns << 9) & ~FILE_BB[0]);
-                }
-                else
-                {
-                    friendly_pawn_attacks = ((friendly_pawns >> 7) & ~FILE_BB[0])
-                        | ((friendly_pawns >> 9) & ~FILE_BB[7]);
-                }
-                // Adjacent: friendly pawn on same rank, adjacent file
-                U64 same_rank = 0xFFULL << (rank * 8);
-                bool is_defended = (pawn_bb & friendly_pawn_attacks) != 0;
-                bool is_adjacent = (friendly_pawns & adj & same_rank) != 0;
-                if (is_defended || is_adjacent)
-                {
-                    mg_score += sign * CONNECTED_PAWN_MG[rank_dist];
-                    eg_score += sign * CONNECTED_PAWN_EG[rank_dist];
-                }
+            // --- Connected pawn ---
+            // Defended by or adjacent to a friendly pawn
+            U64 pawn_bb = 1ULL << sq;
+            U64 friendly_pawn_attacks;
+            if (side == WHITE)
+            {
+                friendly_pawn_attacks = ((friendly_pawns << 7) & ~FILE_BB[7])
+                    | ((friendly_pawns << 9) & ~FILE_BB[0]);
+            }
+            else
+            {
+                friendly_pawn_attacks = ((friendly_pawns >> 7) & ~FILE_BB[0])
+                    | ((friendly_pawns >> 9) & ~FILE_BB[7]);
             }
+            // Adjacent: friendly pawn on same rank, adjacent file
+            U64 same_rank = 0xFFULL << (rank * 8);
+            bool is_defended = (pawn_bb & friendly_pawn_attacks) != 0;
+            bool is_adjacent = (friendly_pawns & adj & same_rank) != 0;
+            if (is_defended || is_adjacent)
+            {
+                mg_score += sign * CONNECTED_PAWN_MG[rank_dist];
+                eg_score += sign * CONNECTED_PAWN_EG[rank_dist];
+            }
+        }
 
-            // --- Doubled pawns ---
-            for (int f = 0; f < 8; f++)
+        // --- Doubled pawns ---
+        for (int f = 0; f < 8; f++)
+        {
+            int count = pop_count(friendly_pawns & FILE_BB[f]);
+            if (count > 1)
             {
-                int count = pop_count(friendly_pawns & FILE_BB[f]);
-                if (count > 1)
-                {
-                    // Penalty for each extra pawn on the file
-                    mg_score += sign * DOUBLED_PAWN_MG * (count - 1);
-                    eg_score += sign * DOUBLED_PAWN_EG * (count - 1);
-                }
+                // Penalty for each extra pawn on the file
+                mg_score += sign * DOUBLED_PAWN_MG * (count - 1);
+                eg_score += sign * DOUBLED_PAWN_EG * (count - 1);
+                doubled_files |= static_cast<U8>(1 << f);
             }
         }
 
-        // Store in pawn hash table
-        entry.key = pawn_hash;
-        entry.mg_score = mg_score;
-        entry.eg_score = eg_score;
+        entry.isolated_files[side] = isolated_files;
+        entry.doubled_files[side] = doubled_files;
+        entry.shelter_king[side] = NULL_SQUARE;
+        entry.shelter[side] = 0;
     }
 
+    entry.mg_score = mg_score;
+    entry.eg_score = eg_score;
+}
+
+int HandCraftedEvaluator::eval_pawn_structure(const PawnHashEntry& pawns, int p)
+{
     // Taper the score
-    int tapered = (mg_score * p + eg_score * (PHASE_MAX - p)) / PHASE_MAX;
+    int tapered = (pawns.mg_score * p + pawns.eg_score * (PHASE_MAX - p)) / PHASE_MAX;
     last_pawn_structure_ = tapered;
     return tapered;
 }
 
-int HandCraftedEvaluator::eval_king_safety(const Board& board, int p)
+// King safety pawn terms of one side (MG, side-relative): a missing shield
+// pawn ahead of the king and a file without friendly pawns, on the king's
+// file and the adjacent ones
+static int king_shelter(U64 friendly_pawns, int king_sq, int side)
+{
+    int king_file = king_sq % 8;
+    int king_rank = king_sq / 8;
+    int score = 0;
+
+    for (int f = std::max(0, king_file - 1); f <= std::min(7, king_file + 1); f++)
+    {
+        // --- Pawn shield ---
+        // 1-2 ranks ahead of the king
+        U64 shield_mask = 0;
+        if (side == WHITE)
+        {
+            for (int r = king_rank + 1; r <= std::min(7, king_rank + 2); r++)
+                shield_mask |= (1ULL << (r * 8 + f));
+        }
+        else
+        {
+            for (int r = king_rank - 1; r >= std::max(0, king_rank - 2); r--)
+                shield_mask |= (1ULL << (r * 8 + f));
+        }
+        if ((friendly_pawns & shield_mask) == 0)
+        {
+            score += KING_PAWN_SHIELD_MG;
+        }
+
+        // --- Open/semi-open files near king ---
+        if ((friendly_pawns & FILE_BB[f]) == 0)
+        {
+            score += KING_OPEN_FILE_MG;
+        }
+    }
+    return score;
+}
+
+int HandCraftedEvaluator::eval_king_safety(const Board& board,
+                                           int p,
+                                           PawnHashEntry& pawns,
+                                           const AttackInfo& attacks)
 {
     // King safety is MG-only; skip in endgame positions
     if (p <= KING_SAFETY_PHASE_THRESHOLD)
@@ -380,117 +480,28 @@ int HandCraftedEvaluator::eval_king_safety(const Board& board, int p)
     }
 
     int mg_score = 0;
-    U64 all_pawns_w = board.bitboard(WHITE_PAWN);
-    U64 all_pawns_b = board.bitboard(BLACK_PAWN);
-    U64 occupied = 0;
-    for (int i = 0; i < NUM_PIECES; i++)
-        occupied |= board.bitboard(i);
 
     for (int side = 0; side <= 1; side++)
     {
         int sign = (side == WHITE) ? 1 : -1;
-        int enemy = 1 - side;
 
         // Find king square
         U64 king_bb = board.bitboard(KING | side);
         if (king_bb == 0)
             continue;
         int king_sq = bit_scan_forward(king_bb);
-        int king_file = king_sq % 8;
-        int king_rank = king_sq / 8;
-
-        U64 friendly_pawns = (side == WHITE) ? all_pawns_w : all_pawns_b;
-        U64 enemy_pawns = (side == WHITE) ? all_pawns_b : all_pawns_w;
 
-        // --- Pawn shield ---
-        // Check king's file and adjacent files, 1-2 ranks ahead of king
-        for (int f = std::max(0, king_file - 1); f <= std::min(7, king_file + 1); f++)
+        // The shelter only depends on the pawns and the king square: keep it
+        // in the pawn hash entry until the king moves
+        if (pawns.shelter_king[side] != king_sq)
         {
-            U64 file_bb = FILE_BB[f];
-            U64 shield_mask = 0;
-            if (side == WHITE)
-            {
-                // Ranks ahead = king_rank + 1 and king_rank + 2
-                for (int r = king_rank + 1; r <= std::min(7, king_rank + 2); r++)
-                    shield_mask |= (1ULL << (r * 8 + f));
-            }
-            else
-            {
-                // Ranks ahead = king_rank - 1 and king_rank - 2
-                for (int r = king_rank - 1; r >= std::max(0, king_rank - 2); r--)
-                    shield_mask |= (1ULL << (r * 8 + f));
-            }
-
-            // If no friendly pawn in the shield zone on this file, penalize
-            if ((friendly_pawns & shield_mask) == 0)
-            {
-                mg_score += sign * KING_PAWN_SHIELD_MG;
-            }
-        }
-
-        // --- Open/semi-open files near king ---
-        for (int f = std::max(0, king_file - 1); f <= std::min(7, king_file + 1); f++)
-        {
-            U64 file_bb = FILE_BB[f];
-            bool has_friendly_pawn = (friendly_pawns & file_bb) != 0;
-            bool has_enemy_pawn = (enemy_pawns & file_bb) != 0;
-
-            // Open file: no pawns at all; semi-open: no friendly pawns
-            if (!has_friendly_pawn)
-            {
-                mg_score += sign * KING_OPEN_FILE_MG;
-            }
+            pawns.shelter[side] = king_shelter(board.bitboard(PAWN | side), king_sq, side);
+            pawns.shelter_king[side] = static_cast<U8>(king_sq);
         }
+        mg_score += sign * pawns.shelter[side];
 
         // --- King zone attacks ---
-        // King zone = king square + 8 neighbors
-        U64 king_zone = KING_LOOKUP_TABLE[king_sq] | (1ULL << king_sq);
-
-        // Count enemy piece attacks on king zone
-        // Enemy knights
-        U64 enemy_knights = board.bitboard(KNIGHT | enemy);
-        while (enemy_knights)
-        {
-            int sq = bit_scan_forward(enemy_knights);
-            enemy_knights &= enemy_knights - 1;
-            U64 attacks = MoveGenerator::knight_targets(1ULL << sq);
-            if (attacks & king_zone)
-                mg_score += sign * KING_ZONE_ATTACK_MG;
-        }
-
-        // Enemy bishops
-        U64 enemy_bishops = board.bitboard(BISHOP | enemy);
-        while (enemy_bishops)
-        {
-            int sq = bit_scan_forward(enemy_bishops);
-            enemy_bishops &= enemy_bishops - 1;
-            U64 attacks = MoveGenerator::bishop_attacks(occupied, sq);
-            if (attacks & king_zone)
-                mg_score += sign * KING_ZONE_ATTACK_MG;
-        }
-
-        // Enemy rooks
-        U64 enemy_rooks = board.bitboard(ROOK | enemy);
-        while (enemy_rooks)
-        {
-            int sq = bit_scan_forward(enemy_rooks);
-            enemy_rooks &= enemy_rooks - 1;
-            U64 attacks = MoveGenerator::rook_attacks(occupied, sq);
-            if (attacks & king_zone)
-                mg_score += sign * KING_ZONE_ATTACK_MG;
-        }
-
-        // Enemy queens (rook + bishop attacks)
-        U64 enemy_queens = board.bitboard(QUEEN | enemy);
-        while (enemy_queens)
-        {
-            int sq = bit_scan_forward(enemy_queens);
-            enemy_queens &= enemy_queens - 1;
-            U64 attacks = MoveGenerator::rook_attacks(occupied, sq)
-                | MoveGenerator::bishop_attacks(occupied, sq);
-            if (attacks & king_zone)
-                mg_score += sign * KING_ZONE_ATTACK_MG;
-        }
+        mg_score += sign * KING_ZONE_ATTACK_MG * attacks.king_zone_attackers[side];
     }
 
     // King safety is MG-only (EG weight = 0), tapered by phase
@@ -509,87 +520,92 @@ static constexpr int MOBILITY_ROOK_EG = 3;
 static constexpr int MOBILITY_QUEEN_MG = 1;
 static constexpr int MOBILITY_QUEEN_EG = 2;
 
-int HandCraftedEvaluator::eval_mobility(const Board& board, int p)
+void AttackInfo::compute(const Board& board)
 {
-    int mg_score = 0;
-    int eg_score = 0;
+    occupied = board.bitboard(WHITE) | board.bitboard(BLACK);
 
-    // Compute occupied bitboard
-    U64 occupied = 0;
-    for (int i = 0; i < NUM_PIECES; i++)
-        occupied |= board.bitboard(i);
-
-    // Compute enemy pawn attack masks
     U64 wp = board.bitboard(WHITE_PAWN);
     U64 bp = board.bitboard(BLACK_PAWN);
-    // White pawn attacks (used to penalize black mobility)
-    U64 w_pawn_attacks = ((wp << 7) & ~FILE_BB[7]) | ((wp << 9) & ~FILE_BB[0]);
-    // Black pawn attacks (used to penalize white mobility)
-    U64 b_pawn_attacks = ((bp >> 7) & ~FILE_BB[0]) | ((bp >> 9) & ~FILE_BB[7]);
+    U64 pawn_attacks[2];
+    pawn_attacks[WHITE] = ((wp << 7) & ~FILE_BB[7]) | ((wp << 9) & ~FILE_BB[0]);
+    pawn_attacks[BLACK] = ((bp >> 7) & ~FILE_BB[0]) | ((bp >> 9) & ~FILE_BB[7]);
 
     for (int side = 0; side <= 1; side++)
     {
-        int sign = (side == WHITE) ? 1 : -1;
+        U64 king_bb = board.bitboard(KING | side);
+        king_zone[side] = king_bb ? KING_LOOKUP_TABLE[bit_scan_forward(king_bb)] | king_bb : 0;
+        king_zone_attackers[side] = 0;
+    }
 
-        // Friendly pieces mask — exclude from mobility squares
-        U64 friendly = 0;
-        for (int pc = side; pc < NUM_PIECES; pc += 2)
-            friendly |= board.bitboard(pc);
+    for (int side = 0; side <= 1; side++)
+    {
+        int enemy = 1 - side;
+        U64 enemy_king_zone = king_zone[enemy];
 
-        // Enemy pawn control — exclude from mobility squares
-        U64 enemy_pawn_ctrl = (side == WHITE) ? b_pawn_attacks : w_pawn_attacks;
-        U64 safe = ~(friendly | enemy_pawn_ctrl);
+        // Mobility counts squares not occupied by friendly pieces nor
+        // controlled by enemy pawns
+        U64 safe = ~(board.bitboard(side) | pawn_attacks[enemy]);
+        int mg = 0;
+        int eg = 0;
 
-        // Knights
         U64 knights = board.bitboard(KNIGHT | side);
         while (knights)
         {
             int sq = bit_scan_forward(knights);
             knights &= knights - 1;
-            U64 attacks = MoveGenerator::knight_targets(1ULL << sq) & safe;
-            int count = pop_count(attacks);
-            mg_score += sign * count * MOBILITY_KNIGHT_MG;
-            eg_score += sign * count * MOBILITY_KNIGHT_EG;
+            U64 attacks = MoveGenerator::knight_targets(1ULL << sq);
+            king_zone_attackers[enemy] += (attacks & enemy_king_zone) != 0;
+            int count = pop_count(attacks & safe);
+            mg += count * MOBILITY_KNIGHT_MG;
+            eg += count * MOBILITY_KNIGHT_EG;
         }
 
-        // Bishops
         U64 bishops = board.bitboard(BISHOP | side);
         while (bishops)
         {
             int sq = bit_scan_forward(bishops);
             bishops &= bishops - 1;
-            U64 attacks = MoveGenerator::bishop_attacks(occupied, sq) & safe;
-            int count = pop_count(attacks);
-            mg_score += sign * count * MOBILITY_BISHOP_MG;
-            eg_score += sign * count * MOBILITY_BISHOP_EG;
+            U64 attacks = MoveGenerator::bishop_attacks(occupied, sq);
+            king_zone_attackers[enemy] += (attacks & enemy_king_zone) != 0;
+            int count = pop_count(attacks & safe);
+            mg += count * MOBILITY_BISHOP_MG;
+            eg += count * MOBILITY_BISHOP_EG;
         }
 
-        // Rooks
         U64 rooks = board.bitboard(ROOK | side);
         while (rooks)
         {
             int sq = bit_scan_forward(rooks);
             rooks &= rooks - 1;
-            U64 attacks = MoveGenerator::rook_attacks(occupied, sq) & safe;
-            int count = pop_count(attacks);
-            mg_score += sign * count * MOBILITY_ROOK_MG;
-            eg_score += sign * count * MOBILITY_ROOK_EG;
+            U64 attacks = MoveGenerator::rook_attacks(occupied, sq);
+            king_zone_attackers[enemy] += (attacks & enemy_king_zone) != 0;
+            int count = pop_count(attacks & safe);
+            mg += count * MOBILITY_ROOK_MG;
+            eg += count * MOBILITY_ROOK_EG;
         }
 
-        // Queens
         U64 queens = board.bitboard(QUEEN | side);
         while (queens)
         {
             int sq = bit_scan_forward(queens);
             queens &= queens - 1;
-            U64 attacks = (MoveGenerator::rook_attacks(occupied, sq)
-                           | MoveGenerator::bishop_attacks(occupied, sq))
-                & safe;
-            int count = pop_count(attacks);
-            mg_score += sign * count * MOBILITY_QUEEN_MG;
-            eg_score += sign * count * MOBILITY_QUEEN_EG;
+            U64 attacks = MoveGenerator::rook_attacks(occupied, sq)
+                | MoveGenerator::bishop_attacks(occupied, sq);
+            king_zone_attackers[enemy] += (attacks & enemy_king_zone) != 0;
+            int count = pop_count(attacks & safe);
+            mg += count * MOBILITY_QUEEN_MG;
+            eg += count * MOBILITY_QUEEN_EG;
         }
+
+        mobility_mg[side] = mg;
+        mobility_eg[side] = eg;
     }
+}
+
+int HandCraftedEvaluator::eval_mobility(const AttackInfo& attacks, int p)
+{
+    int mg_score = attacks.mobility_mg[WHITE] - attacks.mobility_mg[BLACK];
+    int eg_score = attacks.mobility_eg[WHITE] - attacks.mobility_eg[BLACK];
 
     int tapered = (mg_score * p + eg_score * (PHASE_MAX - p)) / PHASE_MAX;
     last_mobility_ = tapered;
@@ -700,7 +716,18 @@ int HandCraftedEvaluator::eval_piece_bonuses(const Board& board, int p)
     return tapered;
 }
 
-int HandCraftedEvaluator::evaluate(const Board& board)
+LazyEvalStats& LazyEvalStats::operator+=(const LazyEvalStats& other)
+{
+    calls += other.calls;
+    exits += other.exits;
+    verified += other.verified;
+    errors += other.errors;
+    max_positional = std::max(max_positional, other.max_positional);
+    return *this;
+}
+
+// Material + PSQT, tapered, and the tempo bonus
+int HandCraftedEvaluator::cheap_score(const Board& board, int p) const
 {
     int mg = 0;
     int eg = 0;
@@ -723,21 +750,46 @@ int HandCraftedEvaluator::evaluate(const Board& board)
         }
     }
 
-    int p = phase(board);
     int score = (mg * p + eg * (PHASE_MAX - p)) / PHASE_MAX;
 
+    if (config_.tempo_enabled)
+    {
+        score += (board.side_to_move() == WHITE) ? 28 : -28;
+    }
+    return score;
+}
+
+// Pawn structure, king safety, mobility and piece bonuses
+int HandCraftedEvaluator::positional_score(const Board& board, int p)
+{
+    int score = 0;
+
+    // One pawn hash probe serves pawn structure and king safety
+    PawnHashEntry* pawns = nullptr;
+    if (config_.pawn_structure_enabled || config_.king_safety_enabled)
+    {
+        pawns = &probe_pawns(board);
+    }
+
     if (config_.pawn_structure_enabled)
     {
-        score += eval_pawn_structure(board, p);
+        score += eval_pawn_structure(*pawns, p);
     }
     else
     {
         last_pawn_structure_ = 0;
     }
 
+    // Attack maps for king safety and mobility
+    AttackInfo attacks;
+    if (config_.king_safety_enabled || config_.mobility_enabled)
+    {
+        attacks.compute(board);
+    }
+
     if (config_.king_safety_enabled)
     {
-        score += eval_king_safety(board, p);
+        score += eval_king_safety(board, p, *pawns, attacks);
     }
     else
     {
@@ -746,7 +798,7 @@ int HandCraftedEvaluator::evaluate(const Board& board)
 
     if (config_.mobility_enabled)
     {
-        score += eval_mobility(board, p);
+        score += eval_mobility(attacks, p);
     }
     else
     {
@@ -762,12 +814,42 @@ int HandCraftedEvaluator::evaluate(const Board& board)
         last_piece_bonuses_ = 0;
     }
 
-    if (config_.tempo_enabled)
+    lazy_stats_.max_positional = std::max(lazy_stats_.max_positional, std::abs(score));
+    return score;
+}
+
+int HandCraftedEvaluator::evaluate(const Board& board)
+{
+    TRACE_SCOPE(TR_HCE_EVAL);
+    int p = phase(board);
+    return cheap_score(board, p) + positional_score(board, p);
+}
+
+int HandCraftedEvaluator::evaluate(const Board& board, int alpha, int beta)
+{
+    TRACE_SCOPE(TR_HCE_EVAL);
+    int p = phase(board);
+    int score = cheap_score(board, p);
+    if (config_.lazy_enabled)
     {
-        score += (board.side_to_move() == WHITE) ? 28 : -28;
+        lazy_stats_.calls++;
+        int margin = config_.lazy_margin;
+        if (score + margin <= alpha || score - margin >= beta)
+        {
+            lazy_stats_.exits++;
+            if (config_.lazy_verify)
+            {
+                int full = score + positional_score(board, p);
+                lazy_stats_.verified++;
+                if ((score <= alpha) != (full <= alpha) || (score >= beta) != (full >= beta))
+                {
+                    lazy_stats_.errors++;
+                }
+            }
+            return score;
+        }
     }
-
-    return score;
+    return score + positional_score(board, p);
 }
 
 int HandCraftedEvaluator::side_relative_eval(const Board& board)
@@ -775,3 +857,12 @@ int HandCraftedEvaluator::side_relative_eval(const Board& board)
     int who2move = (board.side_to_move() == WHITE) ? 1 : -1;
     return who2move * evaluate(board);
 }
+
+int HandCraftedEvaluator::side_relative_eval(const Board& board, int alpha, int beta)
+{
+    if (board.side_to_move() == WHITE)
+    {
+        return evaluate(board, alpha, beta);
+    }
+    return -evaluate(board, -beta, -alpha);
+}
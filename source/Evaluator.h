@@ -14,11 +14,36 @@
 
 class Board;
 
-struct PawnHashEntry
+constexpr int PAWN_HASH_DEFAULT_MB = 2;
+
+/// Everything the evaluation derives from the pawns alone, cached under the
+/// pawn-only Zobrist key. Pawn structure, king safety and the coach's pawn
+/// analysis all read the same entry; one entry fills one cache line.
+struct alignas(64) PawnHashEntry
 {
     U64 key;
-    int mg_score;
+    U64 passed[2];         // passed pawns of each side
+    U64 attack_span[2];    // squares each side's pawns attack now or after advancing
+    int mg_score;          // pawn structure, white-relative
     int eg_score;
+    int shelter[2];        // king safety pawn terms of the side, for shelter_king[side]
+    U8 shelter_king[2];    // NULL_SQUARE until the shelter is computed
+    U8 isolated_files[2];  // bit f set: the side has an isolated pawn on file f
+    U8 doubled_files[2];
+};
+static_assert(sizeof(PawnHashEntry) == 64, "A pawn hash entry should fill one cache line");
+
+/// Attack maps of one position, computed once per evaluation and shared by
+/// the king safety and mobility terms.
+struct AttackInfo
+{
+    U64 occupied;
+    U64 king_zone[2];            // the king's square and its neighbours
+    int king_zone_attackers[2];  // enemy knights, bishops, rooks and queens hitting the zone
+    int mobility_mg[2];          // weighted counts of safe squares
+    int mobility_eg[2];
+
+    void compute(const Board& board);
 };
 
 struct EvalConfig
@@ -28,6 +53,26 @@ struct EvalConfig
     bool pawn_structure_enabled = true;
     bool king_safety_enabled = true;
     bool piece_bonuses_enabled = true;
+    bool pawn_hash_enabled = true;  // off: recompute pawn structure every time
+    // Lazy evaluation: side_relative_eval(board, alpha, beta) returns
+    // material + PSQT + tempo when it is more than lazy_margin outside the
+    // window. lazy_verify also computes the full score on each lazy exit
+    // and counts the exits it would have changed.
+    bool lazy_enabled = true;
+    int lazy_margin = 400;
+    bool lazy_verify = false;
+};
+
+/// How often lazy evaluation exits early, to tune EvalConfig::lazy_margin.
+struct LazyEvalStats
+{
+    U64 calls = 0;         // evaluations with a window
+    U64 exits = 0;         // returned the cheap score
+    U64 verified = 0;      // exits checked against the full score (lazy_verify)
+    U64 errors = 0;        // of those, full score inside the window
+    int max_positional = 0;  // largest |full - cheap| seen by full evaluations
+
+    LazyEvalStats& operator+=(const LazyEvalStats& other);
 };
 
 class Evaluator
@@ -36,15 +81,50 @@ public:
     virtual ~Evaluator() = default;
     virtual int evaluate(const Board& board) = 0;
     virtual int side_relative_eval(const Board& board) = 0;
+    /// Side-relative score, which may be inexact when it is outside
+    /// (alpha, beta): only its side of the window is then guaranteed.
+    virtual int side_relative_eval(const Board& board, int alpha, int beta)
+    {
+        (void)alpha;
+        (void)beta;
+        return side_relative_eval(board);
+    }
 };
 
 class HandCraftedEvaluator : public Evaluator
 {
 public:
     HandCraftedEvaluator();
+    /// A copy takes the configuration and pawn hash size, but starts with
+    /// its own empty caches and statistics: evaluating one copy never
+    /// touches another.
+    HandCraftedEvaluator(const HandCraftedEvaluator& other);
+    HandCraftedEvaluator& operator=(const HandCraftedEvaluator& other);
+    HandCraftedEvaluator(HandCraftedEvaluator&&) = default;
+    HandCraftedEvaluator& operator=(HandCraftedEvaluator&&) = default;
 
     int evaluate(const Board& board) override;
+    /// evaluate() with a white-relative window: returns the cheap terms
+    /// alone when they are more than the lazy margin outside it.
+    int evaluate(const Board& board, int alpha, int beta);
     int side_relative_eval(const Board& board) override;
+    int side_relative_eval(const Board& board, int alpha, int beta) override;
+
+    /// Pawn hash entry of the board's pawns, computed on a miss. With the
+    /// pawn hash disabled it is recomputed into a scratch entry every time.
+    PawnHashEntry& probe_pawns(const Board& board);
+    /// Fill every field of a pawn hash entry but the key from the pawns
+    /// alone (the shelter is left to king safety). Touches no evaluator
+    /// state, for callers that must not write to a pawn hash.
+    static void compute_pawns(PawnHashEntry& entry, U64 white_pawns, U64 black_pawns);
+    /// Resize the pawn hash to the largest power-of-two number of entries
+    /// that fits in size_mb, and clear it. A new evaluator allocates its
+    /// pawn hash on the first probe.
+    void resize_pawn_hash(int size_mb);
+    size_t pawn_hash_entries() const { return pawn_hash_.size(); }
+
+    const LazyEvalStats& lazy_stats() const { return lazy_stats_; }
+    void clear_lazy_stats() { lazy_stats_ = LazyEvalStats(); }
 
     // Runtime configuration
     void set_config(const EvalConfig& cfg) { config_ = cfg; }
@@ -57,27 +137,36 @@ public:
     int get_piece_bonuses_score() const { return last_piece_bonuses_; }
 
 private:
-    void psqt_init();
+    static void psqt_init();
     int phase(const Board& board) const;
-    int eval_pawn_structure(const Board& board, int phase);
-    int eval_king_safety(const Board& board, int phase);
-    int eval_mobility(const Board& board, int phase);
+    int cheap_score(const Board& board, int phase) const;
+    int positional_score(const Board& board, int phase);
+    int eval_pawn_structure(const PawnHashEntry& pawns, int phase);
+    int eval_king_safety(const Board& board,
+                         int phase,
+                         PawnHashEntry& pawns,
+                         const AttackInfo& attacks);
+    int eval_mobility(const AttackInfo& attacks, int phase);
     int eval_piece_bonuses(const Board& board, int phase);
 
-    // Expanded table: piece_square_table_[phase][piece][square]
-    int piece_square_table_[2][14][64];
+    // Expanded table: piece_square_table_[phase][piece][square], shared by
+    // all evaluators
+    static int piece_square_table_[2][14][64];
 
     // Pawn hash table
-    static constexpr int PAWN_HASH_SIZE = 16384;
-    std::vector<PawnHashEntry> pawn_hash_{PAWN_HASH_SIZE};
+    std::vector<PawnHashEntry> pawn_hash_;  // empty until the first probe
+    size_t pawn_hash_mask_ = 0;
+    int pawn_hash_mb_ = PAWN_HASH_DEFAULT_MB;
+    PawnHashEntry pawn_scratch_ {};
 
-    // Cached sub-scores from last evaluate() call
+    // Cached sub-scores from the last full evaluation (not lazy exits)
     int last_pawn_structure_ = 0;
     int last_king_safety_ = 0;
     int last_mobility_ = 0;
     int last_piece_bonuses_ = 0;
 
     EvalConfig config_;
+    LazyEvalStats lazy_stats_;
 };
 
 #endif /* EVALUATOR_H */
@@ -72,7 +72,7 @@ std::unique_ptr<MCTSNode> MCTS::search_return_root(TimeManager* tm)
         // Check time limit every 64 simulations
         if (tm != nullptr && (i & 63) == 0 && i > 0)
         {
-            if (tm->is_time_over(nodes_visited_))
+            if (tm->is_time_over(static_cast<U64>(nodes_visited_)))
             {
                 break;
             }
@@ -1,2 +1,40 @@
+/*
+ * File:   Move.cpp
+ *
+ */
 
 #include "Move.h"
+
+#include "Board.h"
+
+Move unpack_move(PackedMove packed, const Board& board)
+{
+    if (packed.is_null())
+    {
+        return Move(0U);
+    }
+    U8 from = packed.from();
+    U8 to = packed.to();
+    U8 side = board.side_to_move();
+    U16 kind = packed.kind();
+    switch (kind)
+    {
+        case PACKED_KING_CASTLE:
+            return build_castle(KING_CASTLE);
+        case PACKED_QUEEN_CASTLE:
+            return build_castle(QUEEN_CASTLE);
+        case PACKED_EP_CAPTURE:
+            return build_ep_capture(from, to, static_cast<U8>(PAWN | (side ^ 1)));
+        case PACKED_DOUBLE_PUSH:
+            return build_pawn_double_push(from, to);
+        default:
+            break;
+    }
+    U32 flags = NO_FLAGS;
+    if (kind >= PACKED_PROMOTION)
+    {
+        U8 promote_to = static_cast<U8>(((kind - PACKED_PROMOTION + 2) << 1) | side);
+        flags = static_cast<U32>(promote_to) << FLAGS_SHIFT;
+    }
+    return build_move_all(from, to, board[to], flags);
+}
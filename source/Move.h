@@ -121,23 +121,68 @@ inline bool is_ep_capture(Move m) { return m.is_ep_capture(); }
 inline bool is_castle(Move m) { return m.is_castle(); }
 inline bool is_pawn_double_push(Move m) { return m.is_pawn_double_push(); }
 
-// ScoredMove: pairs a Move with a sort score (used only in MoveList)
-struct ScoredMove
+// PackedMove: 16-bit move for storage (TT, killers, countermoves, training
+// data). It keeps what identifies a move in a given position and drops what
+// the board can tell: the captured piece and the promotion colour.
+//   bits  0- 5: from square
+//   bits  6-11: to square
+//   bits 12-15: kind (PACKED_*)
+// Castles keep Move's convention of from = to = 0.
+constexpr U16 PACKED_NORMAL = 0;
+constexpr U16 PACKED_DOUBLE_PUSH = 1;
+constexpr U16 PACKED_EP_CAPTURE = 2;
+constexpr U16 PACKED_KING_CASTLE = 3;
+constexpr U16 PACKED_QUEEN_CASTLE = 4;
+constexpr U16 PACKED_PROMOTION = 8;  // + 0..3 for knight, bishop, rook, queen
+constexpr int PACKED_KIND_SHIFT = 12;
+
+struct PackedMove
 {
-    Move move;
-    int score = 0;
+    U16 data = 0;
 
-    ScoredMove() = default;
-    ScoredMove(Move m, int s)
-        : move(m)
-        , score(s)
+    PackedMove() = default;
+    constexpr explicit PackedMove(U16 raw)
+        : data(raw)
     {
     }
-    explicit ScoredMove(Move m)
-        : move(m)
-        , score(0)
+
+    U8 from() const { return static_cast<U8>(data & 0x3F); }
+    U8 to() const { return static_cast<U8>((data >> 6) & 0x3F); }
+    U16 kind() const { return static_cast<U16>(data >> PACKED_KIND_SHIFT); }
+    bool is_null() const { return data == 0; }
+
+    bool operator==(PackedMove other) const { return data == other.data; }
+    bool operator!=(PackedMove other) const { return data != other.data; }
+};
+static_assert(sizeof(PackedMove) == 2, "PackedMove must stay 16 bits");
+
+inline PackedMove pack_move(Move m)
+{
+    U16 kind = PACKED_NORMAL;
+    if (m.is_promotion())
     {
+        // KNIGHT..QUEEN are 4, 6, 8, 10 (colour in bit 0)
+        kind = static_cast<U16>(PACKED_PROMOTION + (m.promote_to() >> 1) - 2);
     }
-};
+    else if (m.is_castle())
+    {
+        kind = (m.data & KING_CASTLE) ? PACKED_KING_CASTLE : PACKED_QUEEN_CASTLE;
+    }
+    else if (m.is_ep_capture())
+    {
+        kind = PACKED_EP_CAPTURE;
+    }
+    else if (m.is_pawn_double_push())
+    {
+        kind = PACKED_DOUBLE_PUSH;
+    }
+    return PackedMove(
+        static_cast<U16>((m.data & (FROM_MASK | TO_MASK)) | (kind << PACKED_KIND_SHIFT)));
+}
+
+/// The full Move for packed in board's position: the captured piece is read
+/// from the board and the promotion takes the side to move's colour. Packing
+/// then unpacking in the same position returns the original move.
+Move unpack_move(PackedMove packed, const class Board& board);
 
 #endif /* MOVES_H */
@@ -8,10 +8,12 @@
 #include "MoveGenerator.h"
 
 #include "LookupTables.h"
+#include "Trace.h"
 
 namespace MoveGenerator
 {
-void add_moves(U8 from, U64 targets, MoveList& list, const Board& board, const U32 flags)
+template<typename List>
+void add_moves(U8 from, U64 targets, List& list, const Board& board, const U32 flags)
 {
     while (targets)
     {
@@ -23,9 +25,10 @@ void add_moves(U8 from, U64 targets, MoveList& list, const Board& board, const U
     }
 }
 
+template<typename List>
 void add_moves_with_diff(int diff,
                          U64 targets,
-                         MoveList& list,
+                         List& list,
                          const Board& board,
                          const U32 flags,
                          const U8 extra_capture)
@@ -41,8 +44,9 @@ void add_moves_with_diff(int diff,
     }
 }
 
+template<typename List>
 void add_promotions_with_diff(
-    int diff, U64 targets, MoveList& list, const Board& board, const U8 side)
+    int diff, U64 targets, List& list, const Board& board, const U8 side)
 {
     U32 flags = static_cast<U32>(side << FLAGS_SHIFT);
     while (targets)
@@ -222,12 +226,12 @@ U64 bishop_attacks_slow(U64 occ, int sq)
 
 U64 rook_attacks(U64 occ, int sq)
 {
-    return rook_attacks_magic(occ, sq);
+    return slider_use_pext ? rook_attacks_pext(occ, sq) : rook_attacks_magic(occ, sq);
 }
 
 U64 bishop_attacks(U64 occ, int sq)
 {
-    return bishop_attacks_magic(occ, sq);
+    return slider_use_pext ? bishop_attacks_pext(occ, sq) : bishop_attacks_magic(occ, sq);
 }
 
 bool ep_move_discovers_check(const Board& board, U64 from_bb, U64 to_bb, const U8 side)
@@ -245,7 +249,7 @@ bool ep_move_discovers_check(const Board& board, U64 from_bb, U64 to_bb, const U
     return ((rank_attacks(occupied, king_sq) & non_diag_attackers) != BB_EMPTY);
 }
 
-void add_rook_moves(MoveList& list, const Board& board, const U8 side)
+void add_rook_moves(PseudoMoveList& list, const Board& board, const U8 side)
 {
     U64 rooks = board.bitboard(ROOK | side);
     U64 occupied = board.bitboard(WHITE) | board.bitboard(BLACK);
@@ -276,7 +280,7 @@ void add_rook_moves(MoveList& list, const Board& board, const U8 side)
     // cout << "found " << dec <<list.length() << " moves" << endl;
 }
 
-void add_bishop_moves(MoveList& list, const Board& board, const U8 side)
+void add_bishop_moves(PseudoMoveList& list, const Board& board, const U8 side)
 {
     U64 bishops = board.bitboard(BISHOP | side);
     U64 occupied = board.bitboard(WHITE) | board.bitboard(BLACK);
@@ -296,7 +300,7 @@ void add_bishop_moves(MoveList& list, const Board& board, const U8 side)
     }
 }
 
-void add_queen_moves(MoveList& list, const Board& board, const U8 side)
+void add_queen_moves(PseudoMoveList& list, const Board& board, const U8 side)
 {
     U64 queens = board.bitboard(QUEEN | side);
     U64 occupied = board.bitboard(WHITE) | board.bitboard(BLACK);
@@ -316,7 +320,7 @@ void add_queen_moves(MoveList& list, const Board& board, const U8 side)
     }
 }
 
-void add_pawn_pushes(MoveList& list, const Board& board, const U8 side)
+void add_pawn_pushes(PseudoMoveList& list, const Board& board, const U8 side)
 {
     const int diffs[2] = { 8, 64 - 8 };
     const U64 promotions_mask[2] = { ROW_8, ROW_1 };
@@ -341,7 +345,7 @@ void add_pawn_pushes(MoveList& list, const Board& board, const U8 side)
     add_moves_with_diff(diff + diff, double_pushes, list, board, PAWN_DOUBLE_PUSH, 0);
 }
 
-void add_pawn_attacks(MoveList& list, const Board& board, const U8 side)
+void add_pawn_attacks(PseudoMoveList& list, const Board& board, const U8 side)
 {
     const int diffs[2][2] = { { 7, 64 - 9 }, { 9, 64 - 7 } };
     const U64 promotions_mask[2] = { ROW_8, ROW_1 };
@@ -374,7 +378,7 @@ void add_pawn_attacks(MoveList& list, const Board& board, const U8 side)
     }
 }
 
-void add_knight_moves(MoveList& list, const Board& board, const U8 side)
+void add_knight_moves(PseudoMoveList& list, const Board& board, const U8 side)
 {
     U64 knights = board.bitboard(KNIGHT | side);
     U64 non_friendly = ~board.bitboard(side);
@@ -387,7 +391,7 @@ void add_knight_moves(MoveList& list, const Board& board, const U8 side)
     }
 }
 
-void add_king_moves(MoveList& list, const Board& board, const U8 side)
+void add_king_moves(PseudoMoveList& list, const Board& board, const U8 side)
 {
     U64 kings = board.bitboard(KING | side);
     U64 non_friendly = ~board.bitboard(side);
@@ -967,6 +971,7 @@ bool in_check(const Board& board, const U8 side)
 
 void add_all_moves(MoveList& list, const Board& board, const U8 side)
 {
+    TRACE_SCOPE(TR_ALL_MOVES);
     U64 kings = board.bitboard(KING | side);
     assert(pop_count(kings) == 1);
 
@@ -1100,6 +1105,7 @@ void add_pawn_push_promotions(
 /// * Queen promotions (push-promotions, not just capture-promotions)
 void add_loud_moves(MoveList& list, const Board& board, const U8 side)
 {
+    TRACE_SCOPE(TR_LOUD_MOVES);
     U64 kings = board.bitboard(KING | side);
     assert(pop_count(kings) == 1);
 
@@ -1211,7 +1217,7 @@ void score_moves(MoveList& list, const Board& board)
         {
             score = MVVLVA[PAWN >> 1][PAWN >> 1];
         }
-        list.set_score(i, score);
+        list.set_score(i, score * MOVE_SCORE_SCALE);
     }
 }
 #else
@@ -1237,7 +1243,7 @@ void score_moves(MoveList& list, const Board& board)
             }
             if ((SEE_PIECE_VALUE[piece >> 1] - SEE_PIECE_VALUE[captured >> 1]) >= 0)
             {
-                if (see(board, move) < 0)
+                if (!see_ge(board, move, 0))
                 {
                     // Bad capture
                     score = 0;
@@ -1253,7 +1259,18 @@ void score_moves(MoveList& list, const Board& board)
             score = static_cast<U8>(score + 70);
         }
 
-        list.set_score(i, score);
+        if (score == 0)
+        {
+            list.set_score(i, BAD_CAPTURE_SCORE);
+        }
+        else if (score == 5)
+        {
+            list.set_score(i, QUIET_MOVE_SCORE);
+        }
+        else
+        {
+            list.set_score(i, score * MOVE_SCORE_SCALE);
+        }
     }
 }
 #endif
@@ -210,13 +210,14 @@ namespace MoveGenerator
     U64 get_king_danger_squares(const Board& board, U8 side, U64 king);
     U64 get_least_valuable_piece(const Board& board, U64 attadef, U8 side, U8 &piece);
     int see(const Board& board, Move_t move);
-    void add_rook_moves(MoveList &list, const Board &board, U8 side);
-    void add_bishop_moves(MoveList &list, const Board &board, U8 side);
-    void add_pawn_pushes(MoveList &list, const Board &board, U8 side);
-    void add_pawn_attacks(MoveList &list, const Board &board, U8 side);
-    void add_knight_moves(MoveList &list, const Board &board, U8 side);
-    void add_queen_moves(MoveList &list, const Board &board, U8 side);
-    void add_king_moves(MoveList &list, const Board &board, U8 side);
+    bool see_ge(const Board& board, Move_t move, int threshold);
+    void add_rook_moves(PseudoMoveList &list, const Board &board, U8 side);
+    void add_bishop_moves(PseudoMoveList &list, const Board &board, U8 side);
+    void add_pawn_pushes(PseudoMoveList &list, const Board &board, U8 side);
+    void add_pawn_attacks(PseudoMoveList &list, const Board &board, U8 side);
+    void add_knight_moves(PseudoMoveList &list, const Board &board, U8 side);
+    void add_queen_moves(PseudoMoveList &list, const Board &board, U8 side);
+    void add_king_moves(PseudoMoveList &list, const Board &board, U8 side);
     void add_pawn_legal_pushes(MoveList& list, const Board& board, U64 to_mask, U64 from_mask, U8 side);
     void add_pawn_legal_attacks(MoveList& list, const Board& board, U64 capture_mask, U64 push_mask, U64 from_mask, U8 side);
     void add_pawn_legal_moves(MoveList& list, const Board& board, U64 capture_mask, U64 push_mask, U64 from_mask, U8 side);
@@ -238,9 +239,14 @@ namespace MoveGenerator
     void init_magic_tables();
 
     // Internal helpers (used across translation units)
-    void add_moves(U8 from, U64 targets, MoveList &list, const Board &board, U32 flags);
-    void add_moves_with_diff(int diff, U64 targets, MoveList &list, const Board &board, U32 flags, U8 extra_capture);
-    void add_promotions_with_diff(int diff, U64 targets, MoveList &list, const Board &board, U8 side);
+    // (List is MoveList or PseudoMoveList)
+    template<typename List>
+    void add_moves(U8 from, U64 targets, List &list, const Board &board, U32 flags);
+    template<typename List>
+    void add_moves_with_diff(
+        int diff, U64 targets, List &list, const Board &board, U32 flags, U8 extra_capture);
+    template<typename List>
+    void add_promotions_with_diff(int diff, U64 targets, List &list, const Board &board, U8 side);
     bool ep_move_discovers_check(const Board &board, U64 from_bb, U64 to_bb, U8 side);
     U64 rook_targets(U64 from, U64 occupied);
     U64 bishop_targets(U64 from, U64 occupied);
@@ -283,6 +289,17 @@ namespace MoveGenerator
     U64 rook_attacks_magic(U64 occ, int sq);
     U64 bishop_attacks_magic(U64 occ, int sq);
 
+    // BMI2 PEXT backend (MoveGeneratorPext.cpp). rook_attacks() and
+    // bishop_attacks() use it when the CPU has fast PEXT, else magic.
+    enum class SliderBackend { MAGIC, PEXT };
+    extern bool slider_use_pext;
+    bool pext_available();
+    void init_slider_backend();
+    bool set_slider_backend(SliderBackend backend);  // false if PEXT is unavailable
+    SliderBackend slider_backend();
+    U64 rook_attacks_pext(U64 occ, int sq);
+    U64 bishop_attacks_pext(U64 occ, int sq);
+
     U64 attacks_to(const Board& board, U64 occupied, U8 to);
     U64 consider_xrays(const Board& board, U64 occupied, U8 to);
 } // namespace MoveGenerator
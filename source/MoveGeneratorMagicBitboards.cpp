@@ -5,93 +5,95 @@
 
 #include "MoveGenerator.h"
 
-#include <string.h>
-
 #include "LookupTables.h"
 
 // https://www.chessprogramming.org/Magic_Bitboards
 // https://rhysre.net/fast-chess-move-generation-with-magic-bitboards.html
 
-#define ROOK_MB_TABLE_SIZE 4096
-#define BISHOP_MB_TABLE_SIZE 1024
+// Fancy magics: each square's attack sets are packed back to back in one
+// shared table, sized by that square's index bits (2^12 for corner rooks
+// down to 2^5 for central bishops) instead of a fixed 4096/1024 per square.
+// That is 800 KB for rooks and 41 KB for bishops instead of 2.5 MB.
+constexpr int ROOK_ATTACK_TABLE_SIZE = 102400;
+constexpr int BISHOP_ATTACK_TABLE_SIZE = 5248;
+
+// Everything a lookup needs for one square, in one cache line
+struct SquareMagic
+{
+    U64 mask;
+    U64 magic;
+    const U64* attacks;
+    int shift;
+};
 
-// Global variables
-U64 ROOK_MB_TABLE[NUM_SQUARES][ROOK_MB_TABLE_SIZE] = { { 0 } };
-U64 BISHOP_MB_TABLE[NUM_SQUARES][BISHOP_MB_TABLE_SIZE] = { { 0 } };
+static U64 ROOK_ATTACK_TABLE[ROOK_ATTACK_TABLE_SIZE];
+static U64 BISHOP_ATTACK_TABLE[BISHOP_ATTACK_TABLE_SIZE];
+static SquareMagic ROOK_MAGIC[NUM_SQUARES];
+static SquareMagic BISHOP_MAGIC[NUM_SQUARES];
 
-static U64 get_blockers_from_index(int index, U64 mask)
+// Fill one piece's table. Blocker subsets of each mask are enumerated with
+// the carry-rippler trick: https://www.chessprogramming.org/Traversing_Subsets_of_a_Set
+static void init_slider_table(SquareMagic magics[NUM_SQUARES],
+                              U64* table,
+                              int table_size,
+                              const U64 masks[NUM_SQUARES],
+                              const U64 magic_numbers[NUM_SQUARES],
+                              const int index_bits[NUM_SQUARES],
+                              U64 (*attacks_slow)(U64, int))
 {
-    U64 blockers = 0ULL;
-    int bits = pop_count(mask);
-    for (int i = 0; i < bits; i++)
+    int offset = 0;
+    for (int square = 0; square < NUM_SQUARES; square++)
     {
-        int bit_pos = bit_scan_forward(mask);
-        mask &= mask - 1;
-        if (index & (1 << i))
+        U64* attacks = table + offset;
+        magics[square] = { masks[square], magic_numbers[square], attacks, 64 - index_bits[square] };
+        offset += 1 << index_bits[square];
+        assert(offset <= table_size);
+
+        U64 blockers = 0ULL;
+        do
         {
-            blockers |= (1ULL << bit_pos);
-        }
+            U64 index = (blockers * magic_numbers[square]) >> magics[square].shift;
+            attacks[index] = attacks_slow(blockers, square);
+            blockers = (blockers - masks[square]) & masks[square];
+        } while (blockers != 0ULL);
     }
-    return blockers;
+    assert(offset == table_size);
+    (void)table_size;
 }
 
 void MoveGenerator::init_rook_magic_table()
 {
-    memset(ROOK_MB_TABLE, 0, sizeof(ROOK_MB_TABLE));
-    // For all squares
-    for (int square = 0; square < NUM_SQUARES; square++)
-    {
-        // For all possible blockers for this square
-        for (int blocker_index = 0; blocker_index < (1 << ROOK_INDEX_BITS[square]); blocker_index++)
-        {
-            U64 blockers = get_blockers_from_index(blocker_index, ROOK_MB_MASK[square]);
-            U64 index = (blockers * ROOK_MAGICS[square]) >> (64 - ROOK_INDEX_BITS[square]);
-            assert(index < ROOK_MB_TABLE_SIZE);
-            assert(ROOK_MB_TABLE[square][index] == 0);
-            ROOK_MB_TABLE[square][index] = rook_attacks_slow(blockers, square);
-        }
-    }
+    init_slider_table(ROOK_MAGIC, ROOK_ATTACK_TABLE, ROOK_ATTACK_TABLE_SIZE, ROOK_MB_MASK,
+                      ROOK_MAGICS, ROOK_INDEX_BITS, rook_attacks_slow);
 }
 
 void MoveGenerator::init_bishop_magic_table()
 {
-    memset(BISHOP_MB_TABLE, 0, sizeof(BISHOP_MB_TABLE));
-    // For all squares
-    for (int square = 0; square < 64; square++)
-    {
-        // For all possible blockers for this square
-        for (int blocker_index = 0; blocker_index < (1 << BISHOP_INDEX_BITS[square]);
-             blocker_index++)
-        {
-            U64 blockers = get_blockers_from_index(blocker_index, BISHOP_MB_MASK[square]);
-            U64 index = (blockers * BISHOP_MAGICS[square]) >> (64 - BISHOP_INDEX_BITS[square]);
-            assert(index < BISHOP_MB_TABLE_SIZE);
-            assert(BISHOP_MB_TABLE[square][index] == 0);
-            BISHOP_MB_TABLE[square][index] = bishop_attacks_slow(blockers, square);
-        }
-    }
+    init_slider_table(BISHOP_MAGIC, BISHOP_ATTACK_TABLE, BISHOP_ATTACK_TABLE_SIZE, BISHOP_MB_MASK,
+                      BISHOP_MAGICS, BISHOP_INDEX_BITS, bishop_attacks_slow);
 }
 
 void MoveGenerator::init_magic_tables()
 {
-    static bool initialized = false;
-    if (initialized)
-    {
-        return;
-    }
-    init_rook_magic_table();
-    init_bishop_magic_table();
-    initialized = true;
+    // A function-local static is initialized exactly once, even when several
+    // threads get here at the same time; later calls only test a flag.
+    static const bool initialized = (init_rook_magic_table(), init_bishop_magic_table(), true);
+    (void)initialized;
 }
 
+// Build the tables during static initialization, before main() and before
+// any search thread exists. Boards constructed by other static initializers
+// still get them through the call in Board::reset().
+static const bool magic_tables_ready = (MoveGenerator::init_magic_tables(), true);
+
 U64 MoveGenerator::rook_attacks_magic(U64 occ, int sq)
 {
-    occ &= ROOK_MB_MASK[sq];
-    return ROOK_MB_TABLE[sq][(occ * ROOK_MAGICS[sq]) >> (64 - ROOK_INDEX_BITS[sq])];
+    const SquareMagic& m = ROOK_MAGIC[sq];
+    return m.attacks[((occ & m.mask) * m.magic) >> m.shift];
 }
 
 U64 MoveGenerator::bishop_attacks_magic(U64 occ, int sq)
 {
-    occ &= BISHOP_MB_MASK[sq];
-    return BISHOP_MB_TABLE[sq][(occ * BISHOP_MAGICS[sq]) >> (64 - BISHOP_INDEX_BITS[sq])];
+    const SquareMagic& m = BISHOP_MAGIC[sq];
+    return m.attacks[((occ & m.mask) * m.magic) >> m.shift];
 }
@@ -0,0 +1,196 @@
+/*
+ * File:   MoveGeneratorPext.cpp
+ *
+ * BMI2 PEXT slider attacks: the index into a square's attack table is
+ * pext(occupancy, mask), a single instruction instead of the magic
+ * multiply and shift. Tables are packed like the fancy magics, with
+ * 2^popcount(mask) entries per square.
+ *
+ * The instruction is only used when CPUID reports BMI2 on a CPU known to
+ * run it fast: Intel, or AMD from Zen 3 on. Earlier AMD cores and Zen 1
+ * derivatives such as Hygon Dhyana implement PEXT in microcode, slower
+ * than a magic lookup. Otherwise, and on non-x86 builds or with
+ * -Dblunder_PEXT=OFF, rook_attacks()/bishop_attacks() use the magic tables.
+ */
+
+#include "MoveGenerator.h"
+
+#include "LookupTables.h"
+
+#if !defined(NO_PEXT) && (defined(__x86_64__) || defined(_M_X64))
+#define HAS_PEXT 1
+#include <cstring>
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define PEXT_TARGET
+#else
+#include <cpuid.h>
+#define PEXT_TARGET __attribute__((target("bmi2")))
+#endif
+#endif
+
+namespace MoveGenerator
+{
+bool slider_use_pext = false;
+
+#ifdef HAS_PEXT
+constexpr int ROOK_PEXT_TABLE_SIZE = 102400;
+constexpr int BISHOP_PEXT_TABLE_SIZE = 5248;
+
+struct SquarePext
+{
+    U64 mask;
+    const U64* attacks;
+};
+
+static U64 ROOK_PEXT_TABLE[ROOK_PEXT_TABLE_SIZE];
+static U64 BISHOP_PEXT_TABLE[BISHOP_PEXT_TABLE_SIZE];
+static SquarePext ROOK_PEXT[NUM_SQUARES];
+static SquarePext BISHOP_PEXT[NUM_SQUARES];
+
+static void cpuid(unsigned leaf, unsigned regs[4])
+{
+#ifdef _MSC_VER
+    int r[4];
+    __cpuidex(r, static_cast<int>(leaf), 0);
+    for (int i = 0; i < 4; i++)
+    {
+        regs[i] = static_cast<unsigned>(r[i]);
+    }
+#else
+    __cpuid_count(leaf, 0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+static bool cpu_has_fast_pext()
+{
+    unsigned regs[4];
+    cpuid(0, regs);
+    unsigned max_leaf = regs[0];
+    // Vendor string is in ebx, edx, ecx
+    char vendor[13] = {};
+    std::memcpy(vendor, &regs[1], 4);
+    std::memcpy(vendor + 4, &regs[3], 4);
+    std::memcpy(vendor + 8, &regs[2], 4);
+    bool intel = std::strcmp(vendor, "GenuineIntel") == 0;
+    bool amd = std::strcmp(vendor, "AuthenticAMD") == 0;
+    if (max_leaf < 7 || !(intel || amd))
+    {
+        return false;
+    }
+    cpuid(7, regs);
+    bool bmi2 = (regs[1] & (1U << 8)) != 0;
+    if (!bmi2)
+    {
+        return false;
+    }
+    if (amd)
+    {
+        cpuid(1, regs);
+        unsigned family = (regs[0] >> 8) & 0xF;
+        if (family == 0xF)
+        {
+            family += (regs[0] >> 20) & 0xFF;
+        }
+        return family >= 0x19;  // Zen 3
+    }
+    return intel;
+}
+
+PEXT_TARGET static void init_pext_table(SquarePext squares[NUM_SQUARES],
+                                        U64* table,
+                                        int table_size,
+                                        const U64 masks[NUM_SQUARES],
+                                        U64 (*attacks_slow)(U64, int))
+{
+    int offset = 0;
+    for (int square = 0; square < NUM_SQUARES; square++)
+    {
+        U64* attacks = table + offset;
+        squares[square] = { masks[square], attacks };
+        offset += 1 << pop_count(masks[square]);
+        assert(offset <= table_size);
+
+        U64 blockers = 0ULL;
+        do
+        {
+            attacks[_pext_u64(blockers, masks[square])] = attacks_slow(blockers, square);
+            blockers = (blockers - masks[square]) & masks[square];
+        } while (blockers != 0ULL);
+    }
+    assert(offset == table_size);
+    (void)table_size;
+}
+
+PEXT_TARGET U64 rook_attacks_pext(U64 occ, int sq)
+{
+    const SquarePext& p = ROOK_PEXT[sq];
+    return p.attacks[_pext_u64(occ, p.mask)];
+}
+
+PEXT_TARGET U64 bishop_attacks_pext(U64 occ, int sq)
+{
+    const SquarePext& p = BISHOP_PEXT[sq];
+    return p.attacks[_pext_u64(occ, p.mask)];
+}
+
+static bool init_pext()
+{
+    if (!cpu_has_fast_pext())
+    {
+        return false;
+    }
+    init_pext_table(ROOK_PEXT, ROOK_PEXT_TABLE, ROOK_PEXT_TABLE_SIZE, ROOK_MB_MASK,
+                    rook_attacks_slow);
+    init_pext_table(BISHOP_PEXT, BISHOP_PEXT_TABLE, BISHOP_PEXT_TABLE_SIZE, BISHOP_MB_MASK,
+                    bishop_attacks_slow);
+    return true;
+}
+#else
+U64 rook_attacks_pext(U64 occ, int sq)
+{
+    return rook_attacks_magic(occ, sq);
+}
+
+U64 bishop_attacks_pext(U64 occ, int sq)
+{
+    return bishop_attacks_magic(occ, sq);
+}
+
+static bool init_pext()
+{
+    return false;
+}
+#endif
+
+bool pext_available()
+{
+    // Same once-only, thread-safe initialization as the magic tables
+    static const bool available = init_pext();
+    return available;
+}
+
+void init_slider_backend()
+{
+    static const bool selected = (slider_use_pext = pext_available(), true);
+    (void)selected;
+}
+
+bool set_slider_backend(SliderBackend backend)
+{
+    if (backend == SliderBackend::PEXT && !pext_available())
+    {
+        return false;
+    }
+    slider_use_pext = backend == SliderBackend::PEXT;
+    return true;
+}
+
+SliderBackend slider_backend()
+{
+    return slider_use_pext ? SliderBackend::PEXT : SliderBackend::MAGIC;
+}
+
+static const bool slider_backend_ready = (init_slider_backend(), true);
+}  // namespace MoveGenerator
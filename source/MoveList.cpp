@@ -2,13 +2,16 @@
  * File:   MoveList.cpp
  */
 
+#include <algorithm>
+
 #include "MoveList.h"
 
-bool MoveList::contains(Move move)
+template<int Capacity>
+bool BasicMoveList<Capacity>::contains(Move move)
 {
     for (int i = 0; i < size_; i++)
     {
-        if (data_[i].move == move)
+        if (moves_[i] == move)
         {
             return true;
         }
@@ -16,13 +19,14 @@ bool MoveList::contains(Move move)
     return false;
 }
 
-bool MoveList::contains_duplicates()
+template<int Capacity>
+bool BasicMoveList<Capacity>::contains_duplicates()
 {
     for (int i = 0; i < size_; i++)
     {
         for (int j = i + 1; j < size_; j++)
         {
-            if (data_[i].move == data_[j].move)
+            if (moves_[i] == moves_[j])
             {
                 return true;
             }
@@ -31,11 +35,12 @@ bool MoveList::contains_duplicates()
     return false;
 }
 
-bool MoveList::contains_valid_moves(const class Board& board, bool check_legal)
+template<int Capacity>
+bool BasicMoveList<Capacity>::contains_valid_moves(const class Board& board, bool check_legal)
 {
     for (int i = 0; i < size_; i++)
     {
-        if (!is_valid_move(data_[i].move, board, check_legal))
+        if (!is_valid_move(moves_[i], board, check_legal))
         {
             return false;
         }
@@ -43,16 +48,63 @@ bool MoveList::contains_valid_moves(const class Board& board, bool check_legal)
     return true;
 }
 
-void MoveList::sort_moves(int current_index)
+template<int Capacity>
+int BasicMoveList<Capacity>::best_index(int from) const
 {
-    // Selection sort by score
-    for (int i = current_index; i < size_; i++)
+    // Two passes the compiler vectorises: the highest score, then the first
+    // move that has it
+    int16_t best = scores_[from];
+    for (int i = from + 1; i < size_; i++)
+    {
+        best = std::max(best, scores_[i]);
+    }
+    int i = from;
+    while (scores_[i] != best)
     {
-        if (data_[i].score > data_[current_index].score)
+        i++;
+    }
+    return i;
+}
+
+template<int Capacity>
+void BasicMoveList<Capacity>::insertion_sort(int from)
+{
+    // Stable, by descending score
+    for (int i = from + 1; i < size_; i++)
+    {
+        Move_t move = moves_[i];
+        int16_t score = scores_[i];
+        int j = i;
+        while (j > from && scores_[j - 1] < score)
         {
-            ScoredMove tmp = data_[current_index];
-            data_[current_index] = data_[i];
-            data_[i] = tmp;
+            moves_[j] = moves_[j - 1];
+            scores_[j] = scores_[j - 1];
+            j--;
         }
+        moves_[j] = move;
+        scores_[j] = score;
+    }
+    sorted_from_ = from;
+}
+
+template<int Capacity>
+void BasicMoveList<Capacity>::sort_moves(int current_index)
+{
+    if (current_index >= sorted_from_)
+    {
+        return;
+    }
+    int best = best_index(current_index);
+    if (best != current_index)
+    {
+        std::swap(moves_[current_index], moves_[best]);
+        std::swap(scores_[current_index], scores_[best]);
+    }
+    if (scores_[current_index] < QUIET_SORT_LIMIT && size_ - current_index > QUIET_SORT_MIN_MOVES)
+    {
+        insertion_sort(current_index + 1);
     }
 }
+
+template class BasicMoveList<MAX_MOVELIST_LENGTH>;
+template class BasicMoveList<MAX_PSEUDO_MOVELIST_LENGTH>;
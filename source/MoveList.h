@@ -5,43 +5,98 @@
 #ifndef MOVELIST_H
 #define MOVELIST_H
 
+#include <cstdint>
+
 #include "Common.h"
 #include "Board.h"
 #include "ValidateMove.h"
 
-const int MAX_MOVELIST_LENGTH = 256;
+// The most legal moves of any known position. Search keeps one list per
+// frame, so this bounds its stack use.
+const int MAX_MOVELIST_LENGTH = 218;
+
+// The public pseudo-legal generators (add_rook_moves, ...) can go past the
+// legal maximum; they fill a PseudoMoveList instead.
+const int MAX_PSEUDO_MOVELIST_LENGTH = 256;
+
+// Move ordering scores are 16 bit. Captures, promotions, killers and the
+// hash move are buckets MOVE_SCORE_SCALE apart (10 to 255). Quiet moves take
+// the wide band below bucket 10, ordered by history around QUIET_MOVE_SCORE,
+// and losing captures come last.
+constexpr int MOVE_SCORE_SCALE = 128;
+constexpr int QUIET_MOVE_SCORE = -15168;
+constexpr int BAD_CAPTURE_SCORE = INT16_MIN;
+
+// Once sort_moves() picks a move below this score (quiets and bad captures),
+// if more than QUIET_SORT_MIN_MOVES are left they are insertion sorted in
+// one pass: nodes that get this far usually search most of them.
+constexpr int QUIET_SORT_LIMIT = 10 * MOVE_SCORE_SCALE;
+constexpr int QUIET_SORT_MIN_MOVES = 6;
 
-class MoveList
+template<int Capacity>
+class BasicMoveList
 {
   private:
+    // Moves and scores in separate arrays, so picking the best move scans
+    // contiguous scores only
     int size_;
-    ScoredMove data_[MAX_MOVELIST_LENGTH];
+    int sorted_from_;  // moves from here on are in order
+    Move_t moves_[static_cast<size_t>(Capacity)];
+    int16_t scores_[static_cast<size_t>(Capacity)];
+
+    int best_index(int from) const;
+    void insertion_sort(int from);
 
   public:
-    MoveList()
+    BasicMoveList()
         : size_(0)
+        , sorted_from_(Capacity)
     {
     }
     void inline push(Move move)
     {
-        assert(size_ < MAX_MOVELIST_LENGTH);
-        data_[size_++] = ScoredMove(move);
+        assert(size_ < Capacity);
+        moves_[size_] = move;
+        scores_[size_] = 0;
+        size_++;
+        sorted_from_ = Capacity;
     }
     Move inline pop()
     {
         assert(size_ > 0);
-        return data_[--size_].move;
+        return moves_[--size_];
+    }
+    void set_move(int idx, Move move) { moves_[idx] = move; }
+    void set_score(int idx, int score)
+    {
+        assert(score >= INT16_MIN && score <= INT16_MAX);
+        scores_[idx] = static_cast<int16_t>(score);
+        sorted_from_ = Capacity;
+    }
+    int get_score(int idx) const { return scores_[idx]; }
+    Move inline operator[](int idx) const { return moves_[idx]; }
+    void inline reset()
+    {
+        size_ = 0;
+        sorted_from_ = Capacity;
     }
-    void set_move(int idx, Move move) { data_[idx].move = move; }
-    void set_score(int idx, int score) { data_[idx].score = score; }
-    int get_score(int idx) const { return data_[idx].score; }
-    Move inline operator[](int idx) const { return data_[idx].move; }
-    void inline reset() { size_ = 0; }
     int inline length() const { return size_; }
     bool contains(Move move);
     bool contains_duplicates();
     bool contains_valid_moves(const class Board& board, bool check_legal = false);
+    /// Bring the best scored of the moves from current_index on to
+    /// current_index.
     void sort_moves(int current_index);
 };
 
+/// The legal moves of one position, as generated for search
+class MoveList : public BasicMoveList<MAX_MOVELIST_LENGTH>
+{
+};
+
+/// Output of the pseudo-legal generators
+class PseudoMoveList : public BasicMoveList<MAX_PSEUDO_MOVELIST_LENGTH>
+{
+};
+
 #endif /* MOVELIST_H */
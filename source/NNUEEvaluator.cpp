@@ -12,6 +12,7 @@
 #include "NNUEEvaluator.h"
 
 #include "Board.h"
+#include "Trace.h"
 
 // ---------------------------------------------------------------------------
 // Feature index: maps (piece, square) → [0, 768)
@@ -85,6 +86,7 @@ bool NNUEEvaluator::load(const std::string& weights_path)
 // ---------------------------------------------------------------------------
 void NNUEEvaluator::refresh(const Board& board)
 {
+    TRACE_SCOPE(TR_NNUE_REFRESH);
     // Reset both perspectives to biases
     std::memcpy(accumulator_[0], l1_biases_, sizeof(l1_biases_));
     std::memcpy(accumulator_[1], l1_biases_, sizeof(l1_biases_));
@@ -110,6 +112,33 @@ void NNUEEvaluator::refresh(const Board& board)
     }
 }
 
+// ---------------------------------------------------------------------------
+// accumulator_matches — compare the accumulator with a full recomputation
+// ---------------------------------------------------------------------------
+bool NNUEEvaluator::accumulator_matches(const Board& board) const
+{
+    int16_t expected[2][L1_SIZE];
+    std::memcpy(expected[0], l1_biases_, sizeof(l1_biases_));
+    std::memcpy(expected[1], l1_biases_, sizeof(l1_biases_));
+
+    for (int sq = 0; sq < 64; ++sq)
+    {
+        U8 piece = board[sq];
+        if (piece == EMPTY)
+        {
+            continue;
+        }
+        int w_idx = feature_index(piece, sq);
+        int b_idx = feature_index(static_cast<U8>(piece ^ 1), sq ^ 56);
+        for (int j = 0; j < L1_SIZE; ++j)
+        {
+            expected[0][j] += l1_weights_[w_idx * L1_SIZE + j];
+            expected[1][j] += l1_weights_[b_idx * L1_SIZE + j];
+        }
+    }
+    return std::memcmp(expected, accumulator_, sizeof(expected)) == 0;
+}
+
 // ---------------------------------------------------------------------------
 // add_piece — incrementally add a piece to both accumulator perspectives
 // ---------------------------------------------------------------------------
@@ -172,6 +201,7 @@ int16_t NNUEEvaluator::clipped_relu(int32_t x)
 // ---------------------------------------------------------------------------
 int NNUEEvaluator::forward(int perspective) const
 {
+    TRACE_SCOPE(TR_NNUE_FORWARD);
     static constexpr int CONCAT_SIZE = L1_SIZE * 2;  // 512
     static constexpr int QUANT_FACTOR = 64;
 
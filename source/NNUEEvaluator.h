@@ -47,6 +47,7 @@ public:
 
     /// Evaluation relative to the side to move.
     int side_relative_eval(const Board& board) override;
+    using Evaluator::side_relative_eval;
 
     // --- Incremental accumulator updates ---
 
@@ -65,6 +66,10 @@ public:
     /// Recompute the accumulator from scratch for the given board.
     void refresh(const Board& board);
 
+    /// Whether the current accumulator equals what refresh(board) would
+    /// compute (checks incremental updates and push/pop).
+    bool accumulator_matches(const Board& board) const;
+
     /// Whether weights have been loaded successfully.
     bool is_loaded() const { return loaded_; }
 
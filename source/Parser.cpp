@@ -215,14 +215,12 @@ class Board Parser::parse_epd(string epd)
         while (epd[pos] == ' ')
             if (pos++ >= len)
                 return board;
-        cout << "opcode=" << opcode << endl;
 
         string operand;
         while (epd[pos] != ';')
         {
             operand += epd[pos++];
         }
-        cout << "operand=" << operand << endl;
 
         board.set_epd_op(opcode, operand);
 
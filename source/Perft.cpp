@@ -1,16 +1,28 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <memory>
+#include <sstream>
 #include <string>
+#include <thread>
 
 #include "Perft.h"
 
+#include "CLIUtils.h"
+#include "ChildPosition.h"
 #include "Move.h"
 #include "MoveGenerator.h"
 #include "MoveList.h"
+#include "Output.h"
 #include "Parser.h"
 
 using std::cout;
 using std::endl;
 using std::string;
+using std::vector;
 
 // Performance testing
 // https://www.chessprogramming.org/Perft
@@ -47,16 +59,473 @@ long perft_fen(string fen, int depth)
     return move_count;
 }
 
-void perft_benchmark(string fen, int depth)
+// Perft hash: always-replace table of subtree counts. Only used by one
+// thread, so it needs no locking.
+class PerftHash
+{
+public:
+    explicit PerftHash(int size_mb)
+    {
+        size_t entries = static_cast<size_t>(size_mb) * 1024 * 1024 / sizeof(Entry);
+        size_t size = 1;
+        while (size * 2 <= entries)
+        {
+            size *= 2;
+        }
+        table_.resize(size);
+        mask_ = size - 1;
+    }
+
+    bool probe(U64 key, int depth, U64& nodes) const
+    {
+        const Entry& e = table_[key & mask_];
+        if (e.key == key && e.depth == depth)
+        {
+            nodes = e.nodes;
+            return true;
+        }
+        return false;
+    }
+
+    void store(U64 key, int depth, U64 nodes)
+    {
+        Entry& e = table_[key & mask_];
+        e.key = key;
+        e.nodes = nodes;
+        e.depth = depth;
+    }
+
+private:
+    struct Entry
+    {
+        U64 key = 0;
+        U64 nodes = 0;
+        int depth = 0;  // 0 never matches: only depth >= 2 is stored
+    };
+    std::vector<Entry> table_;
+    size_t mask_;
+};
+
+static U64 perft_hashed(Board& board, int depth, PerftHash* hash)
+{
+    U64 nodes;
+    if (hash && depth >= 2 && hash->probe(board.get_hash(), depth, nodes))
+    {
+        return nodes;
+    }
+
+    MoveList list;
+    MoveGenerator::add_all_moves(list, board, board.side_to_move());
+    int n = list.length();
+
+    // Bulk counting: the generator is fully legal
+    if (depth == 1)
+    {
+        return static_cast<U64>(n);
+    }
+
+    nodes = 0;
+    for (int i = 0; i < n; i++)
+    {
+        Move_t move = list[i];
+        board.do_move(move);
+        nodes += perft_hashed(board, depth - 1, hash);
+        board.undo_move(move);
+    }
+
+    if (hash)
+    {
+        hash->store(board.get_hash(), depth, nodes);
+    }
+    return nodes;
+}
+
+std::vector<PerftDivide> perft_divide(const Board& board, int depth, int threads, int hash_mb)
+{
+    MoveList list;
+    Board root = board;
+    MoveGenerator::add_all_moves(list, root, root.side_to_move());
+    int n = list.length();
+
+    std::vector<PerftDivide> result(static_cast<size_t>(n));
+    for (int i = 0; i < n; i++)
+    {
+        result[static_cast<size_t>(i)] = { list[i], 1 };
+    }
+    if (depth <= 1)
+    {
+        return result;
+    }
+
+    // Root moves are handed out one at a time, so a thread that drew a small
+    // subtree picks up the next move instead of idling
+    std::atomic<int> next_move {0};
+    auto worker = [&]()
+    {
+        Board local = board;
+        std::unique_ptr<PerftHash> hash;
+        if (hash_mb > 0)
+        {
+            hash = std::make_unique<PerftHash>(hash_mb);
+        }
+
+        int i;
+        while ((i = next_move.fetch_add(1)) < n)
+        {
+            PerftDivide& entry = result[static_cast<size_t>(i)];
+            local.do_move(entry.move);
+            if (hash)
+            {
+                entry.nodes = perft_hashed(local, depth - 1, hash.get());
+            }
+            else
+            {
+                // No table to key: copy-make children skip the hash and
+                // irreversible-state bookkeeping of do_move
+                entry.nodes = perft_children(ChildPosition::from_board(local), depth - 1);
+            }
+            local.undo_move(entry.move);
+        }
+    };
+
+    threads = std::max(1, std::min(threads, n));
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; t++)
+    {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : pool)
+    {
+        thread.join();
+    }
+    return result;
+}
+
+U64 perft_parallel(const Board& board, int depth, int threads, int hash_mb)
+{
+    U64 nodes = 0;
+    for (const PerftDivide& entry : perft_divide(board, depth, threads, hash_mb))
+    {
+        nodes += entry.nodes;
+    }
+    return nodes;
+}
+
+void perft_benchmark(string fen, int depth, int threads, int hash_mb, bool divide)
 {
     Board board = Parser::parse_fen(fen);
 
-    clock_t tic = clock();
-    long move_count = perft(board, depth);
-    clock_t toc = clock();
+    auto tic = std::chrono::steady_clock::now();
+    std::vector<PerftDivide> moves = perft_divide(board, depth, threads, hash_mb);
+    auto toc = std::chrono::steady_clock::now();
+    double elapsed_secs = std::chrono::duration<double>(toc - tic).count();
+
+    U64 move_count = 0;
+    for (const PerftDivide& entry : moves)
+    {
+        if (divide)
+        {
+            cout << Output::move(entry.move, board) << ": " << entry.nodes << endl;
+        }
+        move_count += entry.nodes;
+    }
 
-    long double elapsed_secs = static_cast<long double>(toc - tic) / CLOCKS_PER_SEC;
     cout << "time: " << elapsed_secs << "s" << endl;
     cout << "moves: " << move_count << endl;
-    cout << "moves per second: " << int(move_count / elapsed_secs) << endl;
+    cout << "moves per second: "
+         << static_cast<U64>(elapsed_secs > 0.0 ? static_cast<double>(move_count) / elapsed_secs
+                                                 : 0.0)
+         << endl;
+}
+
+int perft_suite(const string& path_to_epd, int max_depth, int threads, int hash_mb)
+{
+    std::ifstream file(path_to_epd);
+    if (!file)
+    {
+        cout << "Error: cannot open " << path_to_epd << endl;
+        return 1;
+    }
+
+    int failures = 0;
+    int checks = 0;
+    U64 total_nodes = 0;
+    auto tic = std::chrono::steady_clock::now();
+
+    string line;
+    while (std::getline(file, line))
+    {
+        // <fen> ;D1 <count> ;D2 <count> ...
+        vector<string> fields = split(line, ';');
+        if (fields.empty() || fields[0].find('/') == string::npos)
+        {
+            continue;
+        }
+        Board board = Parser::parse_fen(fields[0]);
+
+        for (size_t f = 1; f < fields.size(); f++)
+        {
+            std::istringstream iss(fields[f]);
+            string tag;
+            U64 expected;
+            if (!(iss >> tag >> expected) || tag.size() < 2 || tag[0] != 'D')
+            {
+                continue;
+            }
+            int depth = str2int(tag.substr(1));
+            if (depth > max_depth)
+            {
+                continue;
+            }
+
+            U64 nodes = perft_parallel(board, depth, threads, hash_mb);
+            total_nodes += nodes;
+            checks++;
+            if (nodes != expected)
+            {
+                failures++;
+                cout << "FAIL " << fields[0] << " depth " << depth << ": expected " << expected
+                     << ", got " << nodes << endl;
+            }
+        }
+    }
+
+    double elapsed_secs =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - tic).count();
+    cout << checks - failures << "/" << checks << " perft counts correct" << endl;
+    cout << "time: " << elapsed_secs << "s" << endl;
+    cout << "moves: " << total_nodes << endl;
+    cout << "moves per second: "
+         << static_cast<U64>(elapsed_secs > 0.0 ? static_cast<double>(total_nodes) / elapsed_secs
+                                                 : 0.0)
+         << endl;
+    return failures;
+}
+
+// Positions exercising castling, en passant and promotions
+// https://www.chessprogramming.org/Perft_Results
+static const char* const PERFT_VERIFY_FENS[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+};
+
+// Everything do_move/undo_move must restore
+struct PositionSnapshot
+{
+    U64 bitboards[14];
+    U8 squares[64];
+    U8 castling_rights;
+    U8 ep_square;
+    U8 side_to_move;
+    int half_move_count;
+    int full_move_count;
+    U64 hash;
+
+    explicit PositionSnapshot(const Board& board)
+    {
+        for (int i = 0; i < 14; i++)
+        {
+            bitboards[i] = board.bitboard(i);
+        }
+        for (int sq = 0; sq < 64; sq++)
+        {
+            squares[sq] = board[sq];
+        }
+        castling_rights = board.castling_rights();
+        ep_square = board.ep_square();
+        side_to_move = board.side_to_move();
+        half_move_count = board.half_move_count();
+        full_move_count = board.full_move_count();
+        hash = board.get_hash();
+    }
+
+    bool operator==(const PositionSnapshot& other) const
+    {
+        return std::equal(bitboards, bitboards + 14, other.bitboards)
+            && std::equal(squares, squares + 64, other.squares)
+            && castling_rights == other.castling_rights && ep_square == other.ep_square
+            && side_to_move == other.side_to_move && half_move_count == other.half_move_count
+            && full_move_count == other.full_move_count && hash == other.hash;
+    }
+};
+
+// Compare incremental state with a full recomputation; empty if consistent
+static string check_position(Board& board, HandCraftedEvaluator& reference)
+{
+    U64 expected[14] = {};
+    for (int sq = 0; sq < 64; sq++)
+    {
+        U8 piece = board[sq];
+        if (piece != EMPTY)
+        {
+            expected[piece] |= 1ULL << sq;
+            expected[piece & 1] |= 1ULL << sq;
+        }
+    }
+    for (int i = 0; i < 14; i++)
+    {
+        if (board.bitboard(i) != expected[i])
+        {
+            return "bitboard " + std::to_string(i) + " does not match the board array";
+        }
+    }
+
+    U64 key = Zobrist::get_zobrist_key(board);
+    if (board.get_hash() != key)
+    {
+        std::ostringstream oss;
+        oss << "incremental hash " << std::hex << board.get_hash() << " != recomputed " << key;
+        return oss.str();
+    }
+
+    NNUEEvaluator* nnue = board.get_nnue();
+    if (nnue != nullptr && nnue->is_loaded() && !nnue->accumulator_matches(board))
+    {
+        return "NNUE accumulator does not match refresh()";
+    }
+
+    int cached = board.get_hce().evaluate(board);
+    int fresh = reference.evaluate(board);
+    if (cached != fresh)
+    {
+        return "HCE eval " + std::to_string(cached) + " with pawn hash != "
+            + std::to_string(fresh) + " recomputed";
+    }
+    return "";
+}
+
+static bool verify_node(Board& board,
+                        int depth,
+                        HandCraftedEvaluator& reference,
+                        PerftVerifyResult& result)
+{
+    result.nodes++;
+    string error = check_position(board, reference);
+    if (!error.empty())
+    {
+        result.error = error;
+        return false;
+    }
+    if (depth == 0)
+    {
+        return true;
+    }
+
+    PositionSnapshot before(board);
+    if (!MoveGenerator::in_check(board, board.side_to_move()))
+    {
+        board.do_null_move();
+        error = check_position(board, reference);
+        if (!error.empty())
+        {
+            result.error = "after null move: " + error;
+            return false;
+        }
+        board.undo_null_move();
+        if (!(PositionSnapshot(board) == before))
+        {
+            result.error = "undo_null_move does not restore the position";
+            return false;
+        }
+    }
+
+    MoveList list;
+    MoveGenerator::add_all_moves(list, board, board.side_to_move());
+    for (int i = 0; i < list.length(); i++)
+    {
+        Move_t move = list[i];
+        result.line.push_back(move);
+        board.do_move(move);
+        if (!verify_node(board, depth - 1, reference, result))
+        {
+            return false;
+        }
+        board.undo_move(move);
+        if (!(PositionSnapshot(board) == before))
+        {
+            result.error = "undo_move does not restore the position";
+            return false;
+        }
+        error = check_position(board, reference);
+        if (!error.empty())
+        {
+            result.error = "after undo_move: " + error;
+            return false;
+        }
+        result.line.pop_back();
+    }
+    return true;
+}
+
+PerftVerifyResult perft_verify(Board& board, int depth)
+{
+    PerftVerifyResult result;
+    HandCraftedEvaluator reference;
+    EvalConfig config = board.get_hce().config();
+    config.pawn_hash_enabled = false;
+    reference.set_config(config);
+
+    result.ok = verify_node(board, depth, reference, result);
+    if (result.ok)
+    {
+        result.line.clear();
+    }
+    return result;
+}
+
+int perft_verify_command(const string& fen, int depth, NNUEEvaluator* nnue)
+{
+    vector<string> fens;
+    if (fen.empty())
+    {
+        fens.assign(std::begin(PERFT_VERIFY_FENS), std::end(PERFT_VERIFY_FENS));
+    }
+    else
+    {
+        fens.push_back(fen);
+    }
+
+    int failures = 0;
+    U64 total_nodes = 0;
+    auto tic = std::chrono::steady_clock::now();
+    for (const string& f : fens)
+    {
+        Board board = Parser::parse_fen(f);
+        if (nnue != nullptr)
+        {
+            board.set_nnue(nnue);
+            nnue->refresh(board);
+        }
+        PerftVerifyResult result = perft_verify(board, depth);
+        total_nodes += result.nodes;
+        if (result.ok)
+        {
+            cout << "ok   " << f << " depth " << depth << ": " << result.nodes << " positions"
+                 << endl;
+            continue;
+        }
+        failures++;
+        cout << "FAIL " << f << " depth " << depth << endl;
+        cout << "  " << result.error << endl;
+        cout << "  moves:";
+        for (Move_t move : result.line)
+        {
+            cout << " " << Output::move(move, board);
+        }
+        cout << endl;
+        cout << "  at: " << Output::board_to_fen(board) << endl;
+    }
+
+    double elapsed_secs =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - tic).count();
+    cout << fens.size() - static_cast<size_t>(failures) << "/" << fens.size()
+         << " positions consistent (" << (nnue != nullptr ? "hce + nnue" : "hce") << ")" << endl;
+    cout << "positions checked: " << total_nodes << endl;
+    cout << "time: " << elapsed_secs << "s" << endl;
+    return failures;
 }
@@ -8,12 +8,65 @@
 #define PERFT_H
 
 #include <string>
+#include <vector>
 
 #include "Common.h"
 #include "Board.h"
 
+/// Leaf count for one root move (perft divide).
+struct PerftDivide
+{
+    Move_t move;
+    U64 nodes;
+};
+
 long perft(class Board &board, int depth);
 long perft_fen(std::string fen, int depth);
-void perft_benchmark(std::string fen, int depth);
+
+/// Perft with the root moves split across a thread pool. Each thread gets
+/// its own copy of the board and, if hash_mb > 0, its own perft hash table
+/// of hash_mb megabytes keyed by (Zobrist key, depth).
+U64 perft_parallel(const class Board &board, int depth, int threads = 1, int hash_mb = 0);
+
+/// Same as perft_parallel, but return the count below each root move.
+std::vector<PerftDivide> perft_divide(const class Board &board,
+                                      int depth,
+                                      int threads = 1,
+                                      int hash_mb = 0);
+
+/// Run perft on fen and print nodes, wall-clock time and nodes per second.
+/// With divide, also print the count below each root move.
+void perft_benchmark(std::string fen,
+                     int depth,
+                     int threads = 1,
+                     int hash_mb = 0,
+                     bool divide = false);
+
+/// Run an EPD perft suite ("<fen> ;D1 20 ;D2 400 ..."), checking every
+/// expected count up to max_depth. Returns the number of failed checks.
+int perft_suite(const std::string &path_to_epd, int max_depth, int threads = 1, int hash_mb = 0);
+
+/// Outcome of perft_verify: the positions checked and, on failure, the
+/// first broken invariant and the moves from the root that reach it.
+struct PerftVerifyResult
+{
+    U64 nodes = 0;
+    bool ok = true;
+    std::string error;
+    std::vector<Move_t> line;
+};
+
+/// Walk the perft tree to depth checking, at every position, the
+/// incrementally updated state against a full recomputation: the Zobrist
+/// key, the bitboards against the board array, the NNUE accumulator (if the
+/// board has loaded weights) and the hand-crafted eval with its pawn hash
+/// against one without. Also checks that undo_move and a null move round
+/// trip restore the position exactly. Stops at the first failure and leaves
+/// the board at the failing position.
+PerftVerifyResult perft_verify(class Board &board, int depth);
+
+/// Run perft_verify on fen, or on a few standard perft positions if fen is
+/// empty, and print the result. Returns the number of failed positions.
+int perft_verify_command(const std::string &fen, int depth, class NNUEEvaluator *nnue = nullptr);
 
 #endif /* PERFT_H */
@@ -0,0 +1,41 @@
+/*
+ * File:   Position.h
+ *
+ * The core chess position as a plain, trivially copyable struct: piece
+ * bitboards, the mailbox and the irreversible state. It holds no evaluator,
+ * transposition table, EPD operations or game history, so copying it is a
+ * 192-byte memcpy. Board embeds one and adds everything else.
+ */
+
+#ifndef POSITION_H
+#define POSITION_H
+
+#include <type_traits>
+
+#include "Common.h"
+
+struct Position
+{
+    /// State that do_move() cannot recompute when undoing a move.
+    struct State
+    {
+        U64 hash;
+        U16 half_move_count;
+        U16 full_move_count;
+        U8 castling_rights;
+        U8 ep_square;
+        U8 side_to_move;
+        U8 unused;
+    };
+
+    U64 bitboards[14];  // WHITE and BLACK occupancy, then one per piece
+    U8 board_array[64];
+    State state;
+
+    U8 operator[](int square) const { return board_array[square]; }
+    U64 bitboard(int type) const { return bitboards[type]; }
+};
+static_assert(std::is_trivially_copyable<Position>::value, "Position should be copied with memcpy");
+static_assert(sizeof(Position) < 200, "Position should stay compact");
+
+#endif /* POSITION_H */
@@ -16,6 +16,7 @@
 #include "Evaluator.h"
 #include "MoveGenerator.h"
 #include "Output.h"
+#include "ValidateMove.h"
 
 // ---------------------------------------------------------------------------
 // Helper: file bitboard constant for file index 0..7
@@ -37,16 +38,16 @@ static constexpr U64 FILE_BB[8] = {
 //   piece_bonuses  — from HCE eval_piece_bonuses()
 //   tempo          — +28 for white-to-move, -28 for black-to-move
 //
-// Calls evaluate() on the board's HCE to populate cached sub-scores, then
-// reads them via the public accessors.
+// Calls evaluate() on the caller's HCE (normally the board's own, so its
+// pawn hash is reused) to populate cached sub-scores, then reads them via the
+// public accessors. The board is not copied.
 // All values are from the side-to-move perspective (matching evaluate()).
 // ---------------------------------------------------------------------------
-EvalBreakdown PositionAnalyzer::compute_eval_breakdown(const Board& board)
+EvalBreakdown PositionAnalyzer::compute_eval_breakdown(const Board& board,
+                                                       HandCraftedEvaluator& hce)
 {
     EvalBreakdown bd {};
-    Board board_copy = board;
-    HandCraftedEvaluator& hce = board_copy.get_hce();
-    int total = hce.evaluate(board_copy);
+    int total = hce.evaluate(board);
 
     bd.pawn_structure = hce.get_pawn_structure_score();
     bd.king_safety = hce.get_king_safety_score();
@@ -54,7 +55,7 @@ EvalBreakdown PositionAnalyzer::compute_eval_breakdown(const Board& board)
     bd.piece_bonuses = hce.get_piece_bonuses_score();
 
     // Tempo: +28 for white-to-move, -28 for black-to-move (white-relative)
-    bd.tempo = (board_copy.side_to_move() == WHITE) ? 28 : -28;
+    bd.tempo = (board.side_to_move() == WHITE) ? 28 : -28;
 
     // Material = total minus all named sub-scores
     bd.material =
@@ -76,8 +77,9 @@ EvalBreakdown PositionAnalyzer::compute_eval_breakdown(const Board& board)
 // ---------------------------------------------------------------------------
 // analyze_pawns()
 //
-// Detects isolated, doubled, and passed pawns for the given side using
-// bitboard operations.
+// Lists the files of isolated, doubled, and passed pawns for the given side,
+// from a pawn hash entry computed the way the evaluation computes it. The
+// entry is local: the board's own pawn hash is left alone.
 //
 // - Isolated: a pawn whose adjacent files have no friendly pawns.
 // - Doubled:  multiple friendly pawns on the same file.
@@ -86,82 +88,26 @@ EvalBreakdown PositionAnalyzer::compute_eval_breakdown(const Board& board)
 // ---------------------------------------------------------------------------
 PawnFeatures PositionAnalyzer::analyze_pawns(const Board& board, U8 side)
 {
-    PawnFeatures features;
+    PawnHashEntry pawns {};
+    HandCraftedEvaluator::compute_pawns(pawns, board.bitboard(WHITE_PAWN),
+                                        board.bitboard(BLACK_PAWN));
 
-    U64 friendly_pawns = board.bitboard(PAWN | side);
-    U64 enemy_pawns = board.bitboard(PAWN | (side ^ 1));
-
-    // Iterate over each file
+    PawnFeatures features;
     for (int f = 0; f < 8; f++)
     {
-        U64 file_bb = FILE_BB[f];
-        U64 pawns_on_file = friendly_pawns & file_bb;
-        int count = pop_count(pawns_on_file);
-
-        if (count == 0)
-            continue;
-
-        // --- Doubled: more than one pawn on this file ---
-        if (count > 1)
+        if (pawns.doubled_files[side] & (1 << f))
         {
             features.doubled.push_back(f);
         }
-
-        // --- Isolated: no friendly pawns on adjacent files ---
-        U64 adjacent_files = BB_EMPTY;
-        if (f > 0)
-            adjacent_files |= FILE_BB[f - 1];
-        if (f < 7)
-            adjacent_files |= FILE_BB[f + 1];
-
-        if ((friendly_pawns & adjacent_files) == 0)
+        if (pawns.isolated_files[side] & (1 << f))
         {
             features.isolated.push_back(f);
         }
-
-        // --- Passed: check each pawn on this file ---
-        U64 pawns_iter = pawns_on_file;
-        while (pawns_iter)
+        if (pawns.passed[side] & FILE_BB[f])
         {
-            U8 sq = bit_scan_forward(pawns_iter);
-            int rank = sq / 8;
-
-            // Build a mask of the file and adjacent files ahead of this pawn
-            U64 front_mask = BB_EMPTY;
-            U64 relevant_files = file_bb | adjacent_files;
-
-            if (side == WHITE)
-            {
-                // "Ahead" for white means higher ranks (rank+1 .. 7)
-                for (int r = rank + 1; r <= 7; r++)
-                {
-                    front_mask |= (0xFFULL << (r * 8));
-                }
-            }
-            else
-            {
-                // "Ahead" for black means lower ranks (rank-1 .. 0)
-                for (int r = rank - 1; r >= 0; r--)
-                {
-                    front_mask |= (0xFFULL << (r * 8));
-                }
-            }
-
-            U64 blocking_zone = relevant_files & front_mask;
-
-            if ((enemy_pawns & blocking_zone) == 0)
-            {
-                // This pawn is passed — add the file if not already added
-                if (features.passed.empty() || features.passed.back() != f)
-                {
-                    features.passed.push_back(f);
-                }
-            }
-
-            pawns_iter &= pawns_iter - 1;  // clear LSB
+            features.passed.push_back(f);
         }
     }
-
     return features;
 }
 
@@ -177,7 +123,7 @@ PawnFeatures PositionAnalyzer::analyze_pawns(const Board& board, U8 side)
 static std::string piece_char(U8 piece_type);
 static std::string piece_on_square_str(U8 piece, U8 sq);
 
-PositionReport PositionAnalyzer::analyze(const Board& board, const std::vector<PVLine>& pv_lines)
+PositionReport PositionAnalyzer::analyze(Board& board, const std::vector<PVLine>& pv_lines)
 {
     PositionReport report {};
 
@@ -185,7 +131,7 @@ PositionReport PositionAnalyzer::analyze(const Board& board, const std::vector<P
     report.fen = Output::board_to_fen(board);
 
     // 2-3. Eval breakdown (always from HCE, even if NNUE is loaded)
-    report.breakdown = compute_eval_breakdown(board);
+    report.breakdown = compute_eval_breakdown(board, board.get_hce());
 
     // eval_cp = sum of breakdown components (ensures consistency)
     report.eval_cp = report.breakdown.material + report.breakdown.pawn_structure
@@ -1012,7 +958,7 @@ std::vector<ThreatMapEntry> PositionAnalyzer::build_threat_map(const Board& boar
 // - In-PV: walk each PV line (first 3-4 moves), apply moves to a board copy,
 //   and check for tactical motifs. Mark these with in_pv: true.
 // ---------------------------------------------------------------------------
-std::vector<Tactic> PositionAnalyzer::detect_tactics(const Board& board,
+std::vector<Tactic> PositionAnalyzer::detect_tactics(Board& board,
                                                      const std::vector<PVLine>& pv_lines)
 {
     std::vector<Tactic> result;
@@ -1380,18 +1326,21 @@ std::vector<Tactic> PositionAnalyzer::detect_tactics(const Board& board,
         if (pv.moves.empty())
             continue;
 
-        Board pv_board = board;
+        // Walk the line on the board itself and take it back afterwards
+        Board& pv_board = board;
         int moves_to_walk = std::min(static_cast<int>(pv.moves.size()), 4);
+        size_t walked = 0;
 
         for (int i = 0; i < moves_to_walk; i++)
         {
             Move_t m = pv.moves[i];
             U8 from_sq = m.from();
             U8 piece_moved = pv_board[from_sq];
-            if (piece_moved == EMPTY)
+            if (piece_moved == EMPTY || !is_valid_move(m, pv_board, false))
                 break;
 
             pv_board.do_move(m);
+            walked++;
 
             // After this move, check for forks by the moved piece
             U8 to_sq = m.to();
@@ -1554,6 +1503,9 @@ std::vector<Tactic> PositionAnalyzer::detect_tactics(const Board& board,
                 }
             }
         }
+
+        while (walked > 0)
+            pv_board.undo_move(pv.moves[--walked]);
     }
 
     return result;
@@ -1597,7 +1549,7 @@ bool PositionAnalyzer::is_critical_moment(const std::vector<PVLine>& pv_lines, s
 //
 // Heuristic labeling based on the first 2-3 moves of a PV line.
 // ---------------------------------------------------------------------------
-std::string PositionAnalyzer::label_line_theme(const Board& board, const std::vector<Move_t>& moves)
+std::string PositionAnalyzer::label_line_theme(Board& board, const std::vector<Move_t>& moves)
 {
     if (moves.empty())
         return "general play";
@@ -1610,16 +1562,17 @@ std::string PositionAnalyzer::label_line_theme(const Board& board, const std::ve
     bool has_center_pawn_move = false;
     bool has_development = false;
 
-    Board board_copy = board;
+    // Walk the line on the board itself and take it back afterwards
+    size_t walked = 0;
 
     for (int i = 0; i < moves_to_check; i++)
     {
         Move_t m = moves[i];
         U8 from = m.from();
         U8 to = m.to();
-        U8 piece_on_from = board_copy[from];
+        U8 piece_on_from = board[from];
 
-        if (piece_on_from == EMPTY)
+        if (piece_on_from == EMPTY || !is_valid_move(m, board, false))
             break;
 
         U8 piece_type = piece_on_from & ~1;  // strip color
@@ -1628,7 +1581,8 @@ std::string PositionAnalyzer::label_line_theme(const Board& board, const std::ve
         if (m.is_castle())
         {
             has_castle = true;
-            board_copy.do_move(m);
+            board.do_move(m);
+            walked++;
             continue;
         }
 
@@ -1658,12 +1612,16 @@ std::string PositionAnalyzer::label_line_theme(const Board& board, const std::ve
         }
 
         // Apply the move and check if it gives check
-        board_copy.do_move(m);
-        U8 opp = board_copy.side_to_move();
-        if (MoveGenerator::in_check(board_copy, opp))
+        board.do_move(m);
+        walked++;
+        U8 opp = board.side_to_move();
+        if (MoveGenerator::in_check(board, opp))
             has_check = true;
     }
 
+    while (walked > 0)
+        board.undo_move(moves[--walked]);
+
     // Priority-based labeling
     if (has_check)
         return "king attack";
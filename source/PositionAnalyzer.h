@@ -90,22 +90,24 @@ struct PositionReport {
 
 class PositionAnalyzer {
 public:
-    // Full position analysis (used by coach eval)
-    static PositionReport analyze(const Board& board,
+    // Full position analysis (used by coach eval). PV lines are walked on
+    // the board itself with do_move()/undo_move(), which leave it unchanged.
+    static PositionReport analyze(Board& board,
                                   const std::vector<PVLine>& pv_lines);
 
     // Individual analysis components (testable in isolation)
-    static EvalBreakdown compute_eval_breakdown(const Board& board);
+    // The breakdown is evaluated with hce, usually board.get_hce().
+    static EvalBreakdown compute_eval_breakdown(const Board& board, HandCraftedEvaluator& hce);
     static std::vector<HangingPiece> find_hanging_pieces(const Board& board, U8 side);
     static std::vector<Threat> find_threats(const Board& board, U8 side);
     static PawnFeatures analyze_pawns(const Board& board, U8 side);
     static KingSafety assess_king_safety(const Board& board, U8 side);
     static std::vector<ThreatMapEntry> build_threat_map(const Board& board);
-    static std::vector<Tactic> detect_tactics(const Board& board,
+    static std::vector<Tactic> detect_tactics(Board& board,
                                                const std::vector<PVLine>& pv_lines);
     static bool is_critical_moment(const std::vector<PVLine>& pv_lines,
                                     std::string& reason);
-    static std::string label_line_theme(const Board& board, const std::vector<Move_t>& moves);
+    static std::string label_line_theme(Board& board, const std::vector<Move_t>& moves);
 };
 
 #endif /* POSITIONANALYZER_H */
@@ -97,7 +97,7 @@ void PrincipalVariation::score_move(MoveList& list,
         if (move == best_move)
         {
             assert(move != 0U);
-            list.set_score(i, 255U);
+            list.set_score(i, 255 * MOVE_SCORE_SCALE);
             return;
         }
     }
@@ -112,7 +112,7 @@ void PrincipalVariation::score_move(MoveList& list,
             if (move == pv_table_[search_ply])
             {
                 follow_pv = 1;
-                list.set_score(i, 128U);
+                list.set_score(i, 128 * MOVE_SCORE_SCALE);
             }
         }
     }
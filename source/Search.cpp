@@ -13,7 +13,6 @@
 
 #include "Search.h"
 
-#include "InputDetect.h"
 #include "MoveGenerator.h"
 #include "MoveList.h"
 #include "ValidateMove.h"
@@ -40,38 +39,42 @@ constexpr int lmp_threshold(int depth)
 constexpr int SE_MIN_DEPTH = 8;
 constexpr int SE_MARGIN = 50;
 
+// Cap on moves remembered per node for history maluses
+constexpr int MAX_TRIED_MOVES = 64;
+
 // Static member definitions for LMR lookup table
 int Search::lmr_table_[MAX_SEARCH_PLY][64] = {};
-bool Search::lmr_initialized_ = false;
 
 void Search::init_lmr_table()
 {
-    if (lmr_initialized_)
-    {
-        return;
-    }
-    // Default: depth=0 or move_index=0 → reduction of 1
-    for (int d = 0; d < MAX_SEARCH_PLY; d++)
-    {
-        lmr_table_[d][0] = 1;
-    }
-    for (int i = 0; i < 64; i++)
-    {
-        lmr_table_[0][i] = 1;
-    }
-    // Logarithmic formula for d >= 1, i >= 1
-    for (int d = 1; d < MAX_SEARCH_PLY; d++)
-    {
-        for (int i = 1; i < 64; i++)
-        {
-            lmr_table_[d][i] = max(1, static_cast<int>(floor(log(d) * log(i) / 2.0)));
-        }
-    }
-    lmr_initialized_ = true;
+    static std::once_flag once;
+    std::call_once(once,
+                   []()
+                   {
+                       // Default: depth=0 or move_index=0 → reduction of 1
+                       for (int d = 0; d < MAX_SEARCH_PLY; d++)
+                       {
+                           lmr_table_[d][0] = 1;
+                       }
+                       for (int i = 0; i < 64; i++)
+                       {
+                           lmr_table_[0][i] = 1;
+                       }
+                       // Logarithmic formula for d >= 1, i >= 1
+                       for (int d = 1; d < MAX_SEARCH_PLY; d++)
+                       {
+                           for (int i = 1; i < 64; i++)
+                           {
+                               lmr_table_[d][i] =
+                                   max(1, static_cast<int>(floor(log(d) * log(i) / 2.0)));
+                           }
+                       }
+                   });
 }
 
 Search::Search(Board& board)
     : board_(board)
+    , cont_history_(std::make_unique<ContinuationHistory[]>(2))
 {
 }
 
@@ -83,22 +86,95 @@ int Search::probe_hash(int depth,
                        int* tt_flags_out,
                        int* tt_value_out)
 {
-    return board_.get_tt().probe(
-        board_.get_hash(), depth, alpha, beta, best_move, tt_depth_out, tt_flags_out, tt_value_out);
+    PackedMove packed;
+    int value = board_.get_tt().probe(
+        board_.get_hash(), depth, alpha, beta, packed, tt_depth_out, tt_flags_out, tt_value_out);
+    best_move = unpack_move(packed, board_);
+    return value;
 }
 
 void Search::record_hash(int depth, int val, int flags, Move_t best_move)
 {
-    board_.get_tt().record(board_.get_hash(), depth, val, flags, best_move);
+    board_.get_tt().record(board_.get_hash(), depth, val, flags, pack_move(best_move));
+}
+
+void Search::clear_history()
+{
+    std::memset(history_, 0, sizeof(history_));
+    std::memset(capture_history_, 0, sizeof(capture_history_));
+    std::memset(countermoves_, 0, sizeof(countermoves_));
+    std::memset(cont_history_.get(), 0, 2 * sizeof(ContinuationHistory));
+}
+
+int& Search::capture_history_entry(Move_t move)
+{
+    U8 piece = board_[move_from(move)] >> 1;
+    U8 captured = board_[move_to(move)] >> 1;
+    if (is_ep_capture(move))
+    {
+        captured = PAWN >> 1;
+    }
+    return capture_history_[piece][move_to(move)][captured];
+}
+
+void Search::moved_piece_to(Move_t move, U8& piece, U8& to) const
+{
+    if (is_castle(move))
+    {
+        // Castles encode no squares: use the king and its destination
+        U8 side = board_.side_to_move();
+        piece = static_cast<U8>(KING | side);
+        int file = (move_flags(move) & (KING_CASTLE >> FLAGS_SHIFT)) ? G1 : C1;
+        to = static_cast<U8>(file + 56 * side);
+    }
+    else
+    {
+        piece = board_[move_from(move)];
+        to = move_to(move);
+    }
+}
+
+Search::PieceToHistory* Search::continuation(int ply, int plies_back)
+{
+    int prev = ply - plies_back;
+    if (prev < 0 || ply_piece_[prev] == EMPTY)
+    {
+        return nullptr;
+    }
+    return &cont_history_[static_cast<size_t>(plies_back - 1)][ply_piece_[prev]][ply_to_[prev]];
+}
+
+void Search::update_quiet_histories(int ply, Move_t move, int bonus)
+{
+    int side = board_.side_to_move();
+    update_history(history_[side][move_from(move)][move_to(move)], bonus);
+
+    PieceToHistory* cont1 = continuation(ply, 1);
+    PieceToHistory* cont2 = continuation(ply, 2);
+    if (cont1 || cont2)
+    {
+        U8 piece;
+        U8 to;
+        moved_piece_to(move, piece, to);
+        if (cont1)
+        {
+            update_history((*cont1)[piece][to], bonus);
+        }
+        if (cont2)
+        {
+            update_history((*cont2)[piece][to], bonus);
+        }
+    }
 }
 
 void Search::store_killer(int ply, Move_t move)
 {
     // Don't store if it's already killer[0]
-    if (killers_[ply][0] != move)
+    PackedMove packed = pack_move(move);
+    if (killers_[ply][0] != packed)
     {
         killers_[ply][1] = killers_[ply][0];
-        killers_[ply][0] = move;
+        killers_[ply][0] = packed;
     }
 }
 
@@ -108,45 +184,65 @@ void Search::score_quiet_moves(MoveList& list, int ply, Move_t prev_move)
     int side = board_.side_to_move();
 
     // Look up the countermove for the previous move (if any)
-    Move_t countermove = 0U;
+    PackedMove countermove;
     if (prev_move != 0U)
     {
         int prev_side = side ^ 1;  // side that made the previous move
         countermove = countermoves_[prev_side][move_from(prev_move)][move_to(prev_move)];
     }
 
+    const PieceToHistory* cont1 = continuation(ply, 1);
+    const PieceToHistory* cont2 = continuation(ply, 2);
+
     for (int i = 0; i < n; i++)
     {
         Move_t move = list[i];
         if (!is_capture(move) && !is_promotion(move))
         {
-            if (move == killers_[ply][0])
+            PackedMove packed = pack_move(move);
+            if (packed == killers_[ply][0])
             {
-                list.set_score(i, 90);
+                list.set_score(i, 90 * MOVE_SCORE_SCALE);
             }
-            else if (move == killers_[ply][1])
+            else if (packed == killers_[ply][1])
             {
-                list.set_score(i, 80);
+                list.set_score(i, 80 * MOVE_SCORE_SCALE);
             }
-            else if (countermove != 0U && move == countermove)
+            else if (!countermove.is_null() && packed == countermove)
             {
-                list.set_score(i, 70);
+                list.set_score(i, 70 * MOVE_SCORE_SCALE);
             }
             else
             {
-                // History tiebreaker for quiet moves: scale into 6..69 range
+                // Butterfly history plus 1- and 2-ply continuation history.
+                // Each term is bounded by HISTORY_MAX, so a third of the sum
+                // stays inside the quiet band.
                 int h = history_[side][move_from(move)][move_to(move)];
-                if (h > 0)
+                if (cont1 || cont2)
                 {
-                    // Map history to 6..69 (above default quiet=5, below countermove=70)
-                    int bonus = 6 + (h * 63) / (h + 1000);
-                    list.set_score(i, bonus);
+                    U8 piece;
+                    U8 to;
+                    moved_piece_to(move, piece, to);
+                    if (cont1)
+                    {
+                        h += (*cont1)[piece][to];
+                    }
+                    if (cont2)
+                    {
+                        h += (*cont2)[piece][to];
+                    }
                 }
+                list.set_score(i, QUIET_MOVE_SCORE + h / 3);
             }
         }
     }
 }
 
+static_assert(QUIET_MOVE_SCORE + HISTORY_MAX < QUIET_SORT_LIMIT,
+              "quiet moves must order below the capture buckets");
+static_assert(QUIET_MOVE_SCORE - HISTORY_MAX > BAD_CAPTURE_SCORE + 9 * MOVE_SCORE_SCALE,
+              "bad captures must order below quiet moves");
+
 void Search::score_captures_with_history(MoveList& list)
 {
     int n = list.length();
@@ -155,19 +251,13 @@ void Search::score_captures_with_history(MoveList& list)
         Move_t move = list[i];
         if (is_capture(move))
         {
-            U8 piece = board_[move_from(move)] >> 1;
-            U8 captured = board_[move_to(move)] >> 1;
-            if (is_ep_capture(move))
-            {
-                captured = PAWN >> 1;
-            }
-            int h = capture_history_[piece][move_to(move)][captured];
+            int h = capture_history_entry(move);
             if (h > 0)
             {
                 // Add a small bonus (1..9) on top of the existing MVV-LVA score
-                int bonus = 1 + (h * 8) / (h + 1000);
+                int bonus = 1 + (h * 8) / (h + HISTORY_MAX / 4);
                 int current = list.get_score(i);
-                list.set_score(i, current + bonus);
+                list.set_score(i, current + bonus * MOVE_SCORE_SCALE);
             }
         }
     }
@@ -237,6 +327,7 @@ Move_t Search::search(int depth,
     // called by the caller (smart time management). Otherwise use legacy start().
     if (search_time != -1 || max_nodes_visited != -1)
     {
+        std::lock_guard<std::mutex> lock(tm_mutex_);
         tm_.start(search_time, max_nodes_visited);
     }
 
@@ -245,12 +336,14 @@ Move_t Search::search(int depth,
 
     board_.set_search_ply(0);
     pv_.reset();
-    abort_ = false;
+    // Killers are ply-indexed and meaningless once the root has moved on;
+    // history and countermoves persist (see clear_history()).
     std::memset(killers_, 0, sizeof(killers_));
-    std::memset(history_, 0, sizeof(history_));
-    std::memset(capture_history_, 0, sizeof(capture_history_));
-    std::memset(countermoves_, 0, sizeof(countermoves_));
     stats_.reset();
+#ifdef SEARCH_STATS
+    tree_stats_.reset();
+#endif
+    completed_depth_ = 0;
 
     // Advance TT generation so stale entries from previous searches can be replaced
     board_.get_tt().new_generation();
@@ -286,37 +379,26 @@ Move_t Search::search(int depth,
         return legal_moves[0];
     }
 
+    // Hard time limit and ponder input are watched off the hot path. The
+    // timer also runs for infinite searches so a ponderhit can arm it.
+    {
+        std::lock_guard<std::mutex> lock(tm_mutex_);
+        timer_.start(abort_, tm_.start_time(), tm_.hard_limit(), pondering_);
+    }
+
+#ifdef SEARCH_TREE_DUMP
+    if (!tree_dump_path_.empty() && !tree_dump_.open(tree_dump_path_, tree_dump_max_nodes_))
+    {
+        std::cerr << "cannot write search tree dump to " << tree_dump_path_ << endl;
+    }
+#endif
+
     int alpha = -MAX_SCORE;
     int beta = MAX_SCORE;
     int best_move_stability = 0;  // consecutive iterations with same best move
 
     for (int current_depth = 1; current_depth <= depth; current_depth++)
     {
-        // Age history tables to prevent unbounded growth
-        if (current_depth > 1)
-        {
-            for (int s = 0; s < 2; ++s)
-            {
-                for (int f = 0; f < 64; ++f)
-                {
-                    for (int t = 0; t < 64; ++t)
-                    {
-                        history_[s][f][t] /= 2;
-                    }
-                }
-            }
-            for (int p = 0; p < 7; ++p)
-            {
-                for (int t = 0; t < 64; ++t)
-                {
-                    for (int c = 0; c < 7; ++c)
-                    {
-                        capture_history_[p][t][c] /= 2;
-                    }
-                }
-            }
-        }
-
         // --- MultiPV loop ---
         excluded_root_moves_.clear();
         std::vector<PVLine> depth_results(effective_multipv);
@@ -329,18 +411,13 @@ Move_t Search::search(int depth,
             int pv_alpha = (pv_index == 0) ? alpha : -MAX_SCORE;
             int pv_beta = (pv_index == 0) ? beta : MAX_SCORE;
 
-            // Reset abort flag before each PV iteration — a previous PV line
-            // may have hit the hard time limit inside alphabeta, setting abort_.
-            // Without this reset, subsequent PV lines return immediately with 0.
-            abort_ = false;
-
             follow_pv_ = 1;
             max_search_ply_ = 0;
 
             int value = alphabeta(pv_alpha, pv_beta, current_depth, IS_PV, DO_NULL);
 
             // If search was aborted, stop and keep results from last fully completed depth
-            if (abort_)
+            if (abort_.load(std::memory_order_relaxed))
             {
                 depth_completed = false;
                 break;
@@ -356,7 +433,7 @@ Move_t Search::search(int depth,
                     follow_pv_ = 1;
                     value = alphabeta(pv_alpha, pv_beta, current_depth, IS_PV, DO_NULL);
 
-                    if (abort_)
+                    if (abort_.load(std::memory_order_relaxed))
                     {
                         depth_completed = false;
                         break;
@@ -386,10 +463,11 @@ Move_t Search::search(int depth,
             // Check time limit between PV iterations (not after the last one).
             // Skip this check entirely for MultiPV > 1 so all requested lines
             // complete at each depth. Time is still checked between depths
-            // (via should_stop after the MultiPV loop) and inside alphabeta
-            // (via is_time_over every 2048 nodes).
+            // (via should_stop after the MultiPV loop) and by the search
+            // timer thread, which raises abort_ at the hard limit.
             if (effective_multipv == 1 && pv_index < effective_multipv - 1)
             {
+                std::lock_guard<std::mutex> lock(tm_mutex_);
                 if (tm_.should_stop(nodes_visited_))
                 {
                     depth_completed = false;
@@ -411,6 +489,7 @@ Move_t Search::search(int depth,
 
         // Commit this depth's results
         multipv_results_ = depth_results;
+        completed_depth_ = current_depth;
 
         // Update search_best_move_ and search_best_score_ from top PV line
         search_best_move_ = multipv_results_[0].best_move();
@@ -419,7 +498,11 @@ Move_t Search::search(int depth,
         clock_t current_time = clock();
         int elapsed_csecs = tm_.elapsed_us() / 10000;
 
-        if (xboard)
+        if (output_mode_ == OutputMode::SILENT)
+        {
+            // No per-iteration output (bench, concurrent searches)
+        }
+        else if (xboard)
         {
             cout << current_depth << " ";
             cout << multipv_results_[0].score << " ";
@@ -482,6 +565,8 @@ Move_t Search::search(int depth,
                 cout << std::defaultfloat << endl;
             }
         }
+        std::lock_guard<std::mutex> tm_lock(tm_mutex_);
+
         // Instability detection: if best move changed, extend time
         if (last_best_move != 0U && search_best_move_ != last_best_move && current_depth >= 4)
         {
@@ -520,6 +605,11 @@ Move_t Search::search(int depth,
         }
     }
 
+    timer_.stop();
+#ifdef SEARCH_TREE_DUMP
+    tree_dump_.close();
+#endif
+
     // Clear exclusion set after search completes
     excluded_root_moves_.clear();
 
@@ -536,6 +626,13 @@ Move_t Search::search(int depth,
     return last_best_move;
 }
 
+void Search::ponderhit(int time_left_cs, int inc_cs, int moves_to_go)
+{
+    std::lock_guard<std::mutex> lock(tm_mutex_);
+    tm_.ponderhit(time_left_cs, inc_cs, moves_to_go);
+    timer_.set_deadline(tm_.hard_limit());
+}
+
 // ---------------------------------------------------------------------------
 // Extract PV moves from the PV table into a vector
 // ---------------------------------------------------------------------------
@@ -561,39 +658,55 @@ std::vector<Move_t> Search::extract_pv_moves() const
 // ---------------------------------------------------------------------------
 int Search::alphabeta(int alpha, int beta, int depth, int is_pv, int can_null, Move_t prev_move)
 {
+#ifdef SEARCH_TREE_DUMP
+    if (tree_dump_.wrap_node())
+    {
+        tree_dump_.enter(board_.get_hash(), depth, board_.get_search_ply(), alpha, beta, 0);
+        int result = alphabeta(alpha, beta, depth, is_pv, can_null, prev_move);
+        tree_dump_.leave(result);
+        return result;
+    }
+#endif
     int search_ply = board_.get_search_ply();
     int mate_value = MATE_SCORE - search_ply;
     int found_pv = 0;
 
     pv_.set_length(search_ply, search_ply);
 
-    // Check time left or abort flag every 2048 nodes
-    if ((nodes_visited_ & 2047) == 0)
+    // Stop flag is raised by the timer thread or an external stop command.
+    // The node budget is plain arithmetic, so check it every 2048 nodes here.
+    if (abort_.load(std::memory_order_relaxed))
     {
-        if (abort_)
-        {
-            return 0;
-        }
-        if (pondering_ && input_available())
-        {
-            abort_ = true;
-            return 0;
-        }
-        if (tm_.is_time_over(nodes_visited_))
-        {
-            abort_ = true;
-            return 0;
-        }
+        return 0;
+    }
+    if ((nodes_visited_ & 2047) == 0 && tm_.node_limit_reached(nodes_visited_))
+    {
+        abort_.store(true, std::memory_order_relaxed);
+        return 0;
     }
     nodes_visited_++;
     stats_.nodes_visited++;
+    TREE_STAT(TC_NODES, search_ply);
 
     // Check for draw
     if (board_.is_draw(true))
     {
+        TREE_DUMP_FLAG(TD_DRAW);
         return DRAW_SCORE;
     }
 
+    // Upcoming repetition: a reversible move reaches a position of the game,
+    // so this node is worth at least a draw
+    if (alpha < DRAW_SCORE && search_ply > 0 && board_.has_game_cycle())
+    {
+        alpha = DRAW_SCORE;
+        if (alpha >= beta)
+        {
+            TREE_DUMP_FLAG(TD_DRAW);
+            return alpha;
+        }
+    }
+
     int hash_flag = HASH_ALPHA;
     Move_t best_move = 0U;
     int tt_depth = 0;
@@ -610,6 +723,8 @@ int Search::alphabeta(int alpha, int beta, int depth, int is_pv, int can_null, M
         if (search_ply != 0 || excluded_root_moves_.empty())
         {
             stats_.hash_hits++;
+            TREE_STAT(TC_TT_CUTOFFS, search_ply);
+            TREE_DUMP_FLAG(TD_TT_CUTOFF);
             return value;
         }
     }
@@ -617,6 +732,7 @@ int Search::alphabeta(int alpha, int beta, int depth, int is_pv, int can_null, M
     // Leaf node
     if (depth == 0)
     {
+        TREE_DUMP_CHILD(0U, 0);
         int q = quiesce(alpha, beta);
         // Apply skill noise in the main search leaf, not in quiescence itself,
         // so the engine still resolves tactical sequences cleanly.
@@ -646,6 +762,10 @@ int Search::alphabeta(int alpha, int beta, int depth, int is_pv, int can_null, M
 
     // Check extension: extend search by 1 ply when in check
     int extension = in_check ? 1 : 0;
+    if (in_check)
+    {
+        TREE_DUMP_FLAG(TD_CHECK_EXT);
+    }
 
     // NULL move pruning
     U8 stm = board_.side_to_move();
@@ -655,12 +775,18 @@ int Search::alphabeta(int alpha, int beta, int depth, int is_pv, int can_null, M
     if ((can_null) && (depth > 2) && !is_pv && !in_check && has_pieces)
     {
         int R = (depth > 6) ? 3 : 2;
+        ply_piece_[search_ply] = EMPTY;
+        TREE_STAT(TC_NULL_TRIES, search_ply);
+        TREE_DUMP_FLAG(TD_NULL_TRY);
+        TREE_DUMP_CHILD(0U, TD_NULL_MOVE | TD_ZERO_WINDOW);
         board_.do_null_move();
         value = -alphabeta(-beta, -beta + 1, depth - 1 - R, NO_PV, NO_NULL, 0U);
         board_.undo_null_move();
 
         if (value >= beta)
         {
+            TREE_STAT(TC_NULL_CUTOFFS, search_ply);
+            TREE_DUMP_FLAG(TD_NULL_CUTOFF);
             return beta;
         }
     }
@@ -678,6 +804,8 @@ int Search::alphabeta(int alpha, int beta, int depth, int is_pv, int can_null, M
         static_eval_computed = true;
         if (static_eval - depth * RFP_MARGIN_PER_DEPTH >= beta)
         {
+            TREE_STAT(TC_RFP_PRUNES, search_ply);
+            TREE_DUMP_FLAG(TD_RFP);
             return beta;
         }
     }
@@ -689,6 +817,9 @@ int Search::alphabeta(int alpha, int beta, int depth, int is_pv, int can_null, M
         && best_move != 0U && (tt_flags == HASH_BETA || tt_flags == HASH_EXACT)
         && tt_depth >= depth - 3)
     {
+        TREE_STAT(TC_SINGULAR_TRIES, search_ply);
+        TREE_DUMP_FLAG(TD_SINGULAR_TRY);
+        TREE_DUMP_CHILD(0U, TD_SINGULAR_VERIFY | TD_ZERO_WINDOW);
         singular_excluded_[search_ply] = true;
         int se_beta = tt_value - SE_MARGIN;
         int se_value = alphabeta(se_beta - 1, se_beta, depth / 2, NO_PV, DO_NULL, prev_move);
@@ -696,6 +827,8 @@ int Search::alphabeta(int alpha, int beta, int depth, int is_pv, int can_null, M
 
         if (se_value < se_beta)
         {
+            TREE_STAT(TC_SINGULAR_EXTENSIONS, search_ply);
+            TREE_DUMP_FLAG(TD_SINGULAR_EXT);
             singular_move = best_move;
         }
     }
@@ -712,6 +845,12 @@ int Search::alphabeta(int alpha, int beta, int depth, int is_pv, int can_null, M
 
     int quiet_moves_searched = 0;
 
+    // Moves searched so far that did not cut off, penalized on a later cutoff
+    Move_t quiets_tried[MAX_TRIED_MOVES];
+    Move_t captures_tried[MAX_TRIED_MOVES];
+    int num_quiets_tried = 0;
+    int num_captures_tried = 0;
+
     for (int i = 0; i < n; i++)
     {
         list.sort_moves(i);
@@ -740,8 +879,10 @@ int Search::alphabeta(int alpha, int beta, int depth, int is_pv, int can_null, M
         }
 
         bool is_quiet = !is_capture(move) && !is_promotion(move);
-        bool is_killer_move =
-            (move == killers_[search_ply][0]) || (move == killers_[search_ply][1]);
+        // Killers are quiet, so only quiet moves are compared
+        bool is_killer_move = is_quiet
+                              && (pack_move(move) == killers_[search_ply][0]
+                                  || pack_move(move) == killers_[search_ply][1]);
 
         // Futility pruning: skip quiet moves at low depths when static eval
         // plus a margin is still below alpha (the move is unlikely to raise alpha).
@@ -761,6 +902,8 @@ int Search::alphabeta(int alpha, int beta, int depth, int is_pv, int can_null, M
                 board_.undo_move(move);
                 if (!gives_check)
                 {
+                    TREE_STAT(TC_FUTILITY_PRUNES, search_ply);
+                    TREE_DUMP_PRUNE(TDP_FUTILITY);
                     continue;
                 }
             }
@@ -771,9 +914,12 @@ int Search::alphabeta(int alpha, int beta, int depth, int is_pv, int can_null, M
         if (depth >= 1 && depth <= 3 && !in_check && !is_pv && is_quiet && !is_killer_move
             && quiet_moves_searched > lmp_threshold(depth))
         {
+            TREE_STAT(TC_LMP_PRUNES, search_ply);
+            TREE_DUMP_PRUNE(TDP_LMP);
             continue;
         }
 
+        moved_piece_to(move, ply_piece_[search_ply], ply_to_[search_ply]);
         board_.do_move(move);
 
         // Per-move extension: check extension + singular extension for TT move
@@ -798,7 +944,13 @@ int Search::alphabeta(int alpha, int beta, int depth, int is_pv, int can_null, M
         {
             if (do_lmr)
             {
+                TREE_STAT(TC_LMR_SEARCHES, search_ply);
+                TREE_DUMP_CHILD(move, TD_LMR | TD_ZERO_WINDOW);
                 value = -alphabeta(-alpha - 1, -alpha, lmr_reduced_depth, NO_PV, DO_NULL, move);
+                if (value > alpha)
+                {
+                    TREE_STAT(TC_LMR_RESEARCHES, search_ply);
+                }
             }
             else
             {
@@ -806,10 +958,12 @@ int Search::alphabeta(int alpha, int beta, int depth, int is_pv, int can_null, M
             }
             if (value > alpha)
             {
+                TREE_DUMP_CHILD(move, do_lmr ? TD_ZERO_WINDOW | TD_RESEARCH : TD_ZERO_WINDOW);
                 value = -alphabeta(
                     -alpha - 1, -alpha, depth - 1 + move_extension, NO_PV, DO_NULL, move);
                 if ((value > alpha) && (value < beta))
                 {
+                    TREE_DUMP_CHILD(move, TD_RESEARCH);
                     value =
                         -alphabeta(-beta, -alpha, depth - 1 + move_extension, IS_PV, DO_NULL, move);
                 }
@@ -819,19 +973,25 @@ int Search::alphabeta(int alpha, int beta, int depth, int is_pv, int can_null, M
         {
             if (do_lmr)
             {
+                TREE_STAT(TC_LMR_SEARCHES, search_ply);
+                TREE_DUMP_CHILD(move, TD_LMR | TD_ZERO_WINDOW);
                 value = -alphabeta(-alpha - 1, -alpha, lmr_reduced_depth, NO_PV, DO_NULL, move);
                 if (value > alpha)
                 {
+                    TREE_STAT(TC_LMR_RESEARCHES, search_ply);
+                    TREE_DUMP_CHILD(move, TD_RESEARCH);
                     value =
                         -alphabeta(-beta, -alpha, depth - 1 + move_extension, is_pv, DO_NULL, move);
                 }
             }
             else
             {
+                TREE_DUMP_CHILD(move, 0);
                 value = -alphabeta(-beta, -alpha, depth - 1 + move_extension, is_pv, DO_NULL, move);
             }
         }
         board_.undo_move(move);
+        TREE_DUMP_MOVE();
         searched_moves_++;
         stats_.total_moves_searched++;
         if (is_quiet)
@@ -849,34 +1009,58 @@ int Search::alphabeta(int alpha, int beta, int depth, int is_pv, int can_null, M
             if (value >= beta)
             {
                 stats_.beta_cutoffs++;
+                TREE_STAT(TC_CUT_NODES, search_ply);
+                TREE_DUMP_FLAG(TD_BETA_CUTOFF);
+                if (num_quiets_tried + num_captures_tried == 0)
+                {
+                    TREE_STAT(TC_FIRST_MOVE_CUTOFFS, search_ply);
+                }
+                int bonus = history_bonus(depth);
                 if (!is_capture(move))
                 {
                     store_killer(search_ply, move);
                     int side = board_.side_to_move();
-                    history_[side][move_from(move)][move_to(move)] += depth * depth;
+                    update_quiet_histories(search_ply, move, bonus);
+
+                    // Quiets searched before the cutoff move get a malus
+                    for (int q = 0; q < num_quiets_tried; q++)
+                    {
+                        update_quiet_histories(search_ply, quiets_tried[q], -bonus);
+                    }
 
                     // Record countermove: this quiet move refutes the previous move
                     if (prev_move != 0U && !is_promotion(move))
                     {
                         int prev_side = side ^ 1;
-                        countermoves_[prev_side][move_from(prev_move)][move_to(prev_move)] = move;
+                        countermoves_[prev_side][move_from(prev_move)][move_to(prev_move)] =
+                            pack_move(move);
                     }
                 }
                 else
                 {
                     // Update capture history for captures that cause cutoffs
-                    U8 piece = board_[move_from(move)] >> 1;
-                    U8 captured = board_[move_to(move)] >> 1;
-                    if (is_ep_capture(move))
-                    {
-                        captured = PAWN >> 1;
-                    }
-                    capture_history_[piece][move_to(move)][captured] += depth * depth;
+                    update_history(capture_history_entry(move), bonus);
+                }
+                for (int c = 0; c < num_captures_tried; c++)
+                {
+                    update_history(capture_history_entry(captures_tried[c]), -bonus);
                 }
                 record_hash(depth, beta, HASH_BETA, best_move);
                 return beta;
             }
         }
+
+        if (!is_capture(move))
+        {
+            if (num_quiets_tried < MAX_TRIED_MOVES)
+            {
+                quiets_tried[num_quiets_tried++] = move;
+            }
+        }
+        else if (num_captures_tried < MAX_TRIED_MOVES)
+        {
+            captures_tried[num_captures_tried++] = move;
+        }
     }
 
     // checkmate or stalemate
@@ -892,6 +1076,7 @@ int Search::alphabeta(int alpha, int beta, int depth, int is_pv, int can_null, M
         }
     }
 
+    TREE_STAT(hash_flag == HASH_EXACT ? TC_PV_NODES : TC_ALL_NODES, search_ply);
     record_hash(depth, alpha, hash_flag, best_move);
     return alpha;
 }
@@ -901,38 +1086,56 @@ int Search::alphabeta(int alpha, int beta, int depth, int is_pv, int can_null, M
 // ---------------------------------------------------------------------------
 int Search::quiesce(int alpha, int beta)
 {
+#ifdef SEARCH_TREE_DUMP
+    if (tree_dump_.wrap_node())
+    {
+        tree_dump_.enter(board_.get_hash(), 0, board_.get_search_ply(), alpha, beta, TD_QNODE);
+        int result = quiesce(alpha, beta);
+        tree_dump_.leave(result);
+        return result;
+    }
+#endif
     int search_ply = board_.get_search_ply();
 
     pv_.set_length(search_ply, search_ply);
 
-    // Check time left or abort flag every 2048 nodes
-    if ((nodes_visited_ & 2047) == 0)
+    // Stop flag is raised by the timer thread or an external stop command.
+    // The node budget is plain arithmetic, so check it every 2048 nodes here.
+    if (abort_.load(std::memory_order_relaxed))
     {
-        if (abort_)
-        {
-            return 0;
-        }
-        if (pondering_ && input_available())
-        {
-            abort_ = true;
-            return 0;
-        }
-        if (tm_.is_time_over(nodes_visited_))
-        {
-            abort_ = true;
-            return 0;
-        }
+        return 0;
+    }
+    if ((nodes_visited_ & 2047) == 0 && tm_.node_limit_reached(nodes_visited_))
+    {
+        abort_.store(true, std::memory_order_relaxed);
+        return 0;
     }
     nodes_visited_++;
     stats_.nodes_visited++;
+    TREE_STAT(TC_QNODES, search_ply);
 
     // Check for draw
     if (board_.is_draw(true))
     {
+        TREE_DUMP_FLAG(TD_DRAW);
         return DRAW_SCORE;
     }
 
-    int stand_pat = board_.get_evaluator().side_relative_eval(board_);
+    // Upcoming repetition: a reversible move reaches a position of the game,
+    // so this node is worth at least a draw
+    if (alpha < DRAW_SCORE && search_ply > 0 && board_.has_game_cycle())
+    {
+        alpha = DRAW_SCORE;
+        if (alpha >= beta)
+        {
+            TREE_DUMP_FLAG(TD_DRAW);
+            return alpha;
+        }
+    }
+
+    // Only the side of the window matters for stand pat, so the evaluator
+    // may skip its positional terms
+    int stand_pat = board_.get_evaluator().side_relative_eval(board_, alpha, beta);
 
     if (search_ply > MAX_SEARCH_PLY - 1)
     {
@@ -941,6 +1144,7 @@ int Search::quiesce(int alpha, int beta)
 
     if (stand_pat >= beta)
     {
+        TREE_DUMP_FLAG(TD_STAND_PAT);
         return beta;
     }
     if (alpha < stand_pat)
@@ -963,14 +1167,18 @@ int Search::quiesce(int alpha, int beta)
         if (is_capture(move))
         {
             // SEE pruning: skip captures that lose material
-            if (MoveGenerator::see(board_, move) < 0)
+            if (!MoveGenerator::see_ge(board_, move, 0))
             {
+                TREE_STAT(TC_SEE_PRUNES, search_ply);
+                TREE_DUMP_PRUNE(TDP_SEE);
                 continue;
             }
 
             board_.do_move(move);
+            TREE_DUMP_CHILD(move, 0);
             int value = -quiesce(-beta, -alpha);
             board_.undo_move(move);
+            TREE_DUMP_MOVE();
             searched_moves_++;
             stats_.total_moves_searched++;
             if (value > alpha)
@@ -980,6 +1188,7 @@ int Search::quiesce(int alpha, int beta)
                 if (value >= beta)
                 {
                     stats_.beta_cutoffs++;
+                    TREE_DUMP_FLAG(TD_BETA_CUTOFF);
                     return beta;
                 }
             }
@@ -988,8 +1197,10 @@ int Search::quiesce(int alpha, int beta)
         {
             // Search promotions (generated by add_loud_moves for push-promotions)
             board_.do_move(move);
+            TREE_DUMP_CHILD(move, 0);
             int value = -quiesce(-beta, -alpha);
             board_.undo_move(move);
+            TREE_DUMP_MOVE();
             searched_moves_++;
             stats_.total_moves_searched++;
             if (value > alpha)
@@ -999,6 +1210,7 @@ int Search::quiesce(int alpha, int beta)
                 if (value >= beta)
                 {
                     stats_.beta_cutoffs++;
+                    TREE_DUMP_FLAG(TD_BETA_CUTOFF);
                     return beta;
                 }
             }
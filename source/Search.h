@@ -12,13 +12,21 @@
 #include "Board.h"
 #include "Evaluator.h"
 #include "PrincipalVariation.h"
+#include "SearchStats.h"
+#include "SearchTreeDump.h"
+#include "SearchTimer.h"
 #include "TimeManager.h"
 #include "TranspositionTable.h"
 
+#include <atomic>
 #include <chrono>
 #include <cmath>
 #include <cstdint>
+#include <cstdlib>
 #include <ctime>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <vector>
 
 constexpr int NO_PV = 0;   // Not a PV node
@@ -26,58 +34,23 @@ constexpr int IS_PV = 1;
 constexpr int NO_NULL = 0;  // avoid doing null move twice in a row
 constexpr int DO_NULL = 1;
 
-struct SearchStats
+// History bound and per-cutoff bonus. Deeper cutoffs weigh more, capped so a
+// single deep cutoff can't saturate an entry.
+constexpr int HISTORY_MAX = 16384;
+constexpr int history_bonus(int depth)
 {
-    int nodes_visited = 0;
-    int hash_probes = 0;
-    int hash_hits = 0;
-    int beta_cutoffs = 0;
-    int total_moves_searched = 0;
-    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
-
-    void reset()
-    {
-        nodes_visited = 0;
-        hash_probes = 0;
-        hash_hits = 0;
-        beta_cutoffs = 0;
-        total_moves_searched = 0;
-        start_time = std::chrono::steady_clock::now();
-    }
-
-    double elapsed_secs() const
-    {
-        auto now = std::chrono::steady_clock::now();
-        return std::chrono::duration<double>(now - start_time).count();
-    }
-
-    int nps() const
-    {
-        double secs = elapsed_secs();
-        return (secs > 0.0) ? static_cast<int>(nodes_visited / secs) : 0;
-    }
-
-    double hash_hit_rate() const
-    {
-        return (hash_probes > 0) ? static_cast<double>(hash_hits) / hash_probes : 0.0;
-    }
-
-    double cutoff_rate() const
-    {
-        return (total_moves_searched > 0)
-            ? static_cast<double>(beta_cutoffs) / total_moves_searched
-            : 0.0;
-    }
-
-    double branching_factor(int depth) const
-    {
-        if (depth <= 0 || nodes_visited <= 0)
-        {
-            return 0.0;
-        }
-        return std::pow(static_cast<double>(nodes_visited), 1.0 / depth);
-    }
-};
+    return (8 * depth * depth < 1600) ? 8 * depth * depth : 1600;
+}
+
+// Gravity update: an entry moves by the bonus (or malus), damped by how close
+// it already is to the bound, so values stay within [-HISTORY_MAX, HISTORY_MAX]
+// and old statistics fade out as new ones arrive. No aging sweeps are needed.
+template<typename T>
+inline void update_history(T& entry, int bonus)
+{
+    int e = entry;
+    entry = static_cast<T>(e + bonus - e * std::abs(bonus) / HISTORY_MAX);
+}
 
 /// Holds one PV line result: the score and the sequence of moves.
 struct PVLine {
@@ -155,26 +128,59 @@ public:
     int get_search_best_score() const { return search_best_score_; }
     PrincipalVariation& get_pv() { return pv_; }
     TimeManager& get_tm() { return tm_; }
+    // Hold while setting up tm_ from another thread than the search, so the
+    // limits cannot race with a concurrent ponderhit()
+    std::unique_lock<std::mutex> lock_tm() { return std::unique_lock<std::mutex>(tm_mutex_); }
     const SearchStats& get_stats() const { return stats_; }
+    // Deepest iteration the last search completed (0 if none did)
+    int get_completed_depth() const { return completed_depth_; }
+    // Per-ply breakdown of the last search (all zero unless built with SEARCH_STATS)
+#ifdef SEARCH_STATS
+    const SearchTreeStats& get_tree_stats() const { return tree_stats_; }
+#else
+    const SearchTreeStats& get_tree_stats() const
+    {
+        static const SearchTreeStats empty;
+        return empty;
+    }
+#endif
+
+    // Dump the first max_nodes nodes of each following search to path
+    // (SearchTreeDump.h); an empty path turns it off. Returns false when the
+    // dump is not compiled in.
+    bool set_tree_dump(const std::string& path, U64 max_nodes)
+    {
+        tree_dump_path_ = path;
+        tree_dump_max_nodes_ = max_nodes;
+        return SEARCH_TREE_DUMP_ENABLED;
+    }
 
     // Access the MultiPV results from the last search
     const std::vector<PVLine>& get_multipv_results() const { return multipv_results_; }
 
     // Killer move accessors (for move scoring)
-    Move_t get_killer(int ply, int slot) const { return killers_[ply][slot]; }
+    PackedMove get_killer(int ply, int slot) const { return killers_[ply][slot]; }
+    int get_history(int side, int from, int to) const { return history_[side][from][to]; }
 
     // Verbose mode: log per-depth statistics during iterative deepening
     void set_verbose(bool v) { verbose_ = v; }
 
     // Output mode for iterative deepening info lines
-    enum class OutputMode { NORMAL, XBOARD, UCI };
+    enum class OutputMode { NORMAL, XBOARD, UCI, SILENT };
     void set_output_mode(OutputMode m) { output_mode_ = m; }
 
-    // Abort mechanism for pondering: external code sets abort to stop search
-    void set_abort(bool a) { abort_ = a; }
-    bool is_aborted() const { return abort_; }
+    // Abort mechanism: external code (UCI stop, SearchTimer) raises the flag
+    // from another thread; the search polls it with a relaxed load per node.
+    // search() never clears it, so a stop sent before the search thread gets
+    // going is not lost: whoever starts a search calls set_abort(false) first.
+    void set_abort(bool a) { abort_.store(a); }
+    bool is_aborted() const { return abort_.load(); }
+
+    // UCI ponderhit: give the running (infinite) ponder search a real time
+    // budget without restarting it. Safe to call from another thread.
+    void ponderhit(int time_left_cs, int inc_cs, int moves_to_go);
 
-    // Pondering mode: search checks input_available() every 2048 nodes
+    // Pondering mode: the search timer thread polls input_available()
     void set_pondering(bool p) { pondering_ = p; }
     bool is_pondering() const { return pondering_; }
 
@@ -189,6 +195,12 @@ public:
     // Advance the game seed so each game gets different noise patterns.
     void new_game_seed() { game_seed_counter_++; }
 
+    // Forget move-ordering history (quiet/capture/continuation history,
+    // countermoves).
+    // These tables persist across search() calls within a game; call this
+    // on a new game so stale statistics from another game aren't reused.
+    void clear_history();
+
 private:
     // Hash helpers (delegate to TT)
     int probe_hash(int depth, int alpha, int beta, Move_t& best_move,
@@ -200,9 +212,17 @@ private:
     PrincipalVariation pv_;
     TimeManager tm_;
     SearchStats stats_;
+#ifdef SEARCH_STATS
+    SearchTreeStats tree_stats_;
+#endif
+    SearchTreeDump tree_dump_;
+    std::string tree_dump_path_;
+    U64 tree_dump_max_nodes_ = 0;
     bool verbose_ = false;
     OutputMode output_mode_ = OutputMode::NORMAL;
-    bool abort_ = false;
+    std::atomic<bool> abort_ {false};
+    SearchTimer timer_;
+    std::mutex tm_mutex_;  // guards tm_ limits against a concurrent ponderhit()
     bool pondering_ = false;
     bool analysis_mode_ = false;
 
@@ -210,35 +230,55 @@ private:
     uint64_t game_seed_counter_ = 0;
 
     int searched_moves_ = 0;
-    int nodes_visited_ = 0;
+    U64 nodes_visited_ = 0;
     int max_search_ply_ = 0;
+    int completed_depth_ = 0;
     Move_t search_best_move_ = 0;
     int search_best_score_ = 0;
     int follow_pv_ = 0;
 
     // Killer move table: two killer slots per ply
-    Move_t killers_[MAX_SEARCH_PLY][2] = {};
+    PackedMove killers_[MAX_SEARCH_PLY][2] = {};
 
     // Countermove table: [side][from_square][to_square]
-    Move_t countermoves_[2][64][64] = {};
+    PackedMove countermoves_[2][64][64] = {};
 
     // History heuristic table: [side][from][to]
+    // Kept in [-HISTORY_MAX, HISTORY_MAX] by gravity updates, which lets it
+    // persist across moves of a game instead of being reset and aged.
     int history_[2][64][64] = {};
 
     // Capture history table: [piece_type][to_square][captured_type]
     // Tracks which captures cause beta cutoffs for better capture ordering.
     // piece_type and captured_type are indexed by piece >> 1 (0..6).
     int capture_history_[7][64][7] = {};
+    int& capture_history_entry(Move_t move);
+
+    // Continuation history: [prev_piece][prev_to][piece][to], indexed by
+    // colored piece. Table [0] scores a quiet move against the move played
+    // 1 ply back (the opponent's reply), table [1] against our own previous
+    // move 2 plies back. ~3 MB, so heap-allocated.
+    using PieceToHistory = int16_t[NUM_PIECES][64];
+    using ContinuationHistory = PieceToHistory[NUM_PIECES][64];
+    std::unique_ptr<ContinuationHistory[]> cont_history_;
+
+    // Piece and destination of the move played at each search ply
+    // (EMPTY for null moves), used to index continuation history.
+    U8 ply_piece_[MAX_SEARCH_PLY] = {};
+    U8 ply_to_[MAX_SEARCH_PLY] = {};
+    void moved_piece_to(Move_t move, U8& piece, U8& to) const;
+    PieceToHistory* continuation(int ply, int plies_back);
 
     // LMR reduction lookup table: [depth][move_index]
+    // Filled once, thread-safe: searches may run concurrently (bench)
     static int lmr_table_[MAX_SEARCH_PLY][64];
-    static bool lmr_initialized_;
     static void init_lmr_table();
 
     // Singular extension tracking
     bool singular_excluded_[MAX_SEARCH_PLY] = {};
 
     void store_killer(int ply, Move_t move);
+    void update_quiet_histories(int ply, Move_t move, int bonus);
     void score_quiet_moves(MoveList& list, int ply, Move_t prev_move);
     void score_captures_with_history(MoveList& list);
 
@@ -0,0 +1,79 @@
+/*
+ * File:   SearchStats.cpp
+ *
+ */
+
+#include <iomanip>
+
+#include "SearchStats.h"
+
+static double percent(U64 part, U64 whole)
+{
+    return (whole > 0) ? 100.0 * static_cast<double>(part) / static_cast<double>(whole) : 0.0;
+}
+
+void SearchTreeStats::print(std::ostream& os) const
+{
+    if (!SEARCH_TREE_STATS)
+    {
+        os << "search tree stats not compiled in (configure with -Dblunder_SEARCH_STATS=ON)"
+           << std::endl;
+        return;
+    }
+
+    const TreeCounter columns[] = {
+        TC_NODES,          TC_QNODES,         TC_PV_NODES,        TC_CUT_NODES,
+        TC_ALL_NODES,      TC_FIRST_MOVE_CUTOFFS, TC_TT_CUTOFFS,  TC_NULL_TRIES,
+        TC_NULL_CUTOFFS,   TC_RFP_PRUNES,     TC_FUTILITY_PRUNES, TC_LMP_PRUNES,
+        TC_SEE_PRUNES,     TC_LMR_SEARCHES,   TC_LMR_RESEARCHES,  TC_SINGULAR_TRIES,
+        TC_SINGULAR_EXTENSIONS,
+    };
+    const char* headers[] = {
+        "nodes", "qnodes", "pv", "cut", "all", "cut1st", "tt", "null",
+        "nullcut", "rfp", "futil", "lmp", "see", "lmr", "lmr-re", "se", "se-ext",
+    };
+
+    os << std::setw(4) << "ply";
+    for (const char* h : headers)
+    {
+        os << std::setw(11) << h;
+    }
+    os << std::endl;
+
+    for (int ply = 0; ply < MAX_SEARCH_PLY; ply++)
+    {
+        if (counts[ply][TC_NODES] == 0 && counts[ply][TC_QNODES] == 0)
+        {
+            continue;
+        }
+        os << std::setw(4) << ply;
+        for (TreeCounter c : columns)
+        {
+            os << std::setw(11) << counts[ply][c];
+        }
+        os << std::endl;
+    }
+
+    os << std::setw(4) << "all";
+    for (TreeCounter c : columns)
+    {
+        os << std::setw(11) << total(c);
+    }
+    os << std::endl;
+
+    U64 nodes = total(TC_NODES);
+    U64 qnodes = total(TC_QNODES);
+    U64 cuts = total(TC_CUT_NODES);
+    os << std::fixed << std::setprecision(1);
+    os << "qsearch share:        " << percent(qnodes, nodes + qnodes) << "%" << std::endl;
+    os << "first-move cutoffs:   " << percent(total(TC_FIRST_MOVE_CUTOFFS), cuts) << "%"
+       << std::endl;
+    os << "null move success:    " << percent(total(TC_NULL_CUTOFFS), total(TC_NULL_TRIES))
+       << "%" << std::endl;
+    os << "LMR re-search rate:   " << percent(total(TC_LMR_RESEARCHES), total(TC_LMR_SEARCHES))
+       << "%" << std::endl;
+    os << "singular extensions:  "
+       << percent(total(TC_SINGULAR_EXTENSIONS), total(TC_SINGULAR_TRIES)) << "%" << std::endl;
+    os << "TT cutoffs:           " << percent(total(TC_TT_CUTOFFS), nodes) << "% of nodes"
+       << std::endl;
+}
@@ -0,0 +1,151 @@
+/*
+ * File:   SearchStats.h
+ *
+ * Search counters.
+ *
+ * SearchStats holds the always-on totals reported after each iteration.
+ * SearchTreeStats breaks the tree down per ply and per event (node type,
+ * pruning, reductions, extensions). It costs an increment per event in the
+ * hot path, so the counting is only compiled in when SEARCH_STATS is defined
+ * (cmake -Dblunder_SEARCH_STATS=ON); otherwise TREE_STAT() expands to nothing.
+ */
+
+#ifndef SEARCH_STATS_H
+#define SEARCH_STATS_H
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <ostream>
+
+#include "Constants.h"
+#include "Types.h"
+
+#ifdef SEARCH_STATS
+constexpr bool SEARCH_TREE_STATS = true;
+#define TREE_STAT(counter, ply) tree_stats_.add((counter), (ply))
+#else
+constexpr bool SEARCH_TREE_STATS = false;
+#define TREE_STAT(counter, ply) ((void)0)
+#endif
+
+struct SearchStats
+{
+    U64 nodes_visited = 0;
+    U64 hash_probes = 0;
+    U64 hash_hits = 0;
+    U64 beta_cutoffs = 0;
+    U64 total_moves_searched = 0;
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+    void reset()
+    {
+        nodes_visited = 0;
+        hash_probes = 0;
+        hash_hits = 0;
+        beta_cutoffs = 0;
+        total_moves_searched = 0;
+        start_time = std::chrono::steady_clock::now();
+    }
+
+    double elapsed_secs() const
+    {
+        auto now = std::chrono::steady_clock::now();
+        return std::chrono::duration<double>(now - start_time).count();
+    }
+
+    U64 nps() const
+    {
+        double secs = elapsed_secs();
+        return (secs > 0.0) ? static_cast<U64>(static_cast<double>(nodes_visited) / secs) : 0;
+    }
+
+    double hash_hit_rate() const
+    {
+        return (hash_probes > 0) ? static_cast<double>(hash_hits) / static_cast<double>(hash_probes)
+                                 : 0.0;
+    }
+
+    double cutoff_rate() const
+    {
+        return (total_moves_searched > 0)
+            ? static_cast<double>(beta_cutoffs) / static_cast<double>(total_moves_searched)
+            : 0.0;
+    }
+
+    double branching_factor(int depth) const
+    {
+        if (depth <= 0 || nodes_visited == 0)
+        {
+            return 0.0;
+        }
+        return std::pow(static_cast<double>(nodes_visited), 1.0 / depth);
+    }
+};
+
+/// Events counted per ply by SearchTreeStats.
+/// Node types are assigned by outcome: a node that returns an exact score is a
+/// PV node, one that fails high a cut node, one that fails low an all node.
+/// Nodes that return before the move loop (TT hit, null move, RFP, leaf) are
+/// only counted in TC_NODES and their own pruning counter.
+enum TreeCounter
+{
+    TC_NODES,               // alphabeta() nodes
+    TC_QNODES,              // quiesce() nodes
+    TC_PV_NODES,            // exact score
+    TC_CUT_NODES,           // failed high in the move loop
+    TC_ALL_NODES,           // failed low
+    TC_FIRST_MOVE_CUTOFFS,  // failed high on the first move searched
+    TC_TT_CUTOFFS,          // returned from a hash table probe
+    TC_NULL_TRIES,          // null move searched
+    TC_NULL_CUTOFFS,        // null move failed high
+    TC_RFP_PRUNES,          // reverse futility pruning
+    TC_FUTILITY_PRUNES,     // quiet move skipped by futility pruning
+    TC_LMP_PRUNES,          // quiet move skipped by late move pruning
+    TC_SEE_PRUNES,          // losing capture skipped in quiescence
+    TC_LMR_SEARCHES,        // reduced search
+    TC_LMR_RESEARCHES,      // reduced search beat alpha, searched again
+    TC_SINGULAR_TRIES,      // singular verification search
+    TC_SINGULAR_EXTENSIONS, // TT move found singular and extended
+    NUM_TREE_COUNTERS
+};
+
+struct SearchTreeStats
+{
+    U64 counts[MAX_SEARCH_PLY][NUM_TREE_COUNTERS] = {};
+
+    void reset() { std::memset(counts, 0, sizeof(counts)); }
+
+    SearchTreeStats& operator+=(const SearchTreeStats& other)
+    {
+        for (int ply = 0; ply < MAX_SEARCH_PLY; ply++)
+        {
+            for (int c = 0; c < NUM_TREE_COUNTERS; c++)
+            {
+                counts[ply][c] += other.counts[ply][c];
+            }
+        }
+        return *this;
+    }
+
+    void add(TreeCounter counter, int ply)
+    {
+        // Quiescence can run one ply past the last search ply
+        counts[ply < MAX_SEARCH_PLY ? ply : MAX_SEARCH_PLY - 1][counter]++;
+    }
+
+    U64 total(TreeCounter counter) const
+    {
+        U64 sum = 0;
+        for (int ply = 0; ply < MAX_SEARCH_PLY; ply++)
+        {
+            sum += counts[ply][counter];
+        }
+        return sum;
+    }
+
+    /// Print a per-ply table followed by totals and derived rates.
+    void print(std::ostream& os) const;
+};
+
+#endif /* SEARCH_STATS_H */
@@ -0,0 +1,86 @@
+/*
+ * File:   SearchTimer.cpp
+ *
+ */
+
+#include <algorithm>
+
+#include "SearchTimer.h"
+
+#include "InputDetect.h"
+
+void SearchTimer::start(std::atomic<bool>& flag,
+                        TimeManager::TimePoint start,
+                        int deadline_us,
+                        bool poll_input)
+{
+    stop();
+
+    flag_ = &flag;
+    start_ = start;
+    deadline_us_ = deadline_us;
+    poll_input_ = poll_input;
+    quit_ = false;
+    thread_ = std::thread(&SearchTimer::run, this);
+}
+
+void SearchTimer::set_deadline(int deadline_us)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        deadline_us_ = deadline_us;
+    }
+    cv_.notify_one();
+}
+
+void SearchTimer::stop()
+{
+    if (!thread_.joinable())
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        quit_ = true;
+    }
+    cv_.notify_one();
+    thread_.join();
+}
+
+void SearchTimer::run()
+{
+    using Clock = TimeManager::Clock;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!quit_)
+    {
+        auto now = Clock::now();
+
+        if (deadline_us_ != -1 && now - start_ >= std::chrono::microseconds(deadline_us_))
+        {
+            flag_->store(true, std::memory_order_relaxed);
+            deadline_us_ = -1;
+        }
+        if (poll_input_ && input_available())
+        {
+            flag_->store(true, std::memory_order_relaxed);
+            poll_input_ = false;
+        }
+
+        bool has_deadline = (deadline_us_ != -1);
+        if (!has_deadline && !poll_input_)
+        {
+            // Nothing left to watch: sleep until stopped or re-armed
+            cv_.wait(lock);
+            continue;
+        }
+
+        auto wake = has_deadline ? start_ + std::chrono::microseconds(deadline_us_)
+                                 : now + std::chrono::microseconds(INPUT_POLL_US);
+        if (poll_input_)
+        {
+            wake = (std::min)(wake, now + std::chrono::microseconds(INPUT_POLL_US));
+        }
+        cv_.wait_until(lock, wake);
+    }
+}
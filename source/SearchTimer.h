@@ -0,0 +1,67 @@
+/*
+ * File:   SearchTimer.h
+ *
+ * Watchdog thread that raises the search stop flag.
+ *
+ * The search hot loop only does a relaxed load of an std::atomic<bool>.
+ * Everything that can end a search from the outside -- the hard time limit
+ * and (while pondering in xboard mode) pending stdin input -- is watched by
+ * this thread instead, so alphabeta/quiesce never call steady_clock::now()
+ * or select().  Stop latency no longer depends on how long 2048 nodes take.
+ */
+
+#ifndef SEARCHTIMER_H
+#define SEARCHTIMER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "TimeManager.h"
+
+class SearchTimer
+{
+public:
+    SearchTimer() = default;
+    ~SearchTimer() { stop(); }
+
+    SearchTimer(const SearchTimer&) = delete;
+    SearchTimer& operator=(const SearchTimer&) = delete;
+
+    /// Start the watchdog thread.
+    /// @param flag         Stop flag to raise (must outlive the timer thread)
+    /// @param start        Reference point for the deadline
+    /// @param deadline_us  Raise the flag this many microseconds after start (-1 = never)
+    /// @param poll_input   Also raise the flag as soon as stdin has data
+    void start(std::atomic<bool>& flag,
+               TimeManager::TimePoint start,
+               int deadline_us,
+               bool poll_input);
+
+    /// Move the deadline of a running timer (-1 = no deadline).
+    /// The new deadline is relative to the same start point.
+    void set_deadline(int deadline_us);
+
+    /// Stop and join the watchdog thread. Safe to call when not running.
+    void stop();
+
+    bool is_running() const { return thread_.joinable(); }
+
+private:
+    void run();
+
+    // Input polling interval while pondering (xboard has no stop command)
+    static constexpr int INPUT_POLL_US = 1000;
+
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::atomic<bool>* flag_ = nullptr;
+    TimeManager::TimePoint start_ {};
+    int deadline_us_ = -1;
+    bool poll_input_ = false;
+    bool quit_ = false;
+};
+
+#endif /* SEARCHTIMER_H */
@@ -0,0 +1,94 @@
+/*
+ * File:   SearchTreeDump.cpp
+ *
+ */
+
+#include <cstring>
+
+#include "SearchTreeDump.h"
+
+static constexpr char TREE_DUMP_MAGIC[8] = {'B', 'L', 'T', 'R', 'E', 'E', '1', '\0'};
+static constexpr size_t TREE_DUMP_BUFFER_RECORDS = 4096;
+
+bool SearchTreeDump::open(const std::string& path, U64 max_nodes)
+{
+    close();
+    file_ = std::fopen(path.c_str(), "wb");
+    if (file_ == nullptr)
+    {
+        return false;
+    }
+    uint32_t record_size = sizeof(TreeDumpRecord);
+    std::fwrite(TREE_DUMP_MAGIC, 1, sizeof(TREE_DUMP_MAGIC), file_);
+    std::fwrite(&record_size, sizeof(record_size), 1, file_);
+
+    max_nodes_ = max_nodes;
+    next_id_ = 1;
+    wrapped_ = false;
+    child_move_ = 0;
+    child_flags_ = 0;
+    frames_.clear();
+    frames_.reserve(2 * MAX_SEARCH_PLY);
+    buffer_.clear();
+    buffer_.reserve(TREE_DUMP_BUFFER_RECORDS);
+    return true;
+}
+
+void SearchTreeDump::close()
+{
+    if (file_ == nullptr)
+    {
+        return;
+    }
+    flush();
+    std::fclose(file_);
+    file_ = nullptr;
+    frames_.clear();
+}
+
+void SearchTreeDump::enter(U64 hash, int depth, int ply, int alpha, int beta, uint16_t flags)
+{
+    Frame frame;
+    std::memset(&frame.record, 0, sizeof(frame.record));
+    frame.recorded = next_id_ <= max_nodes_;
+    if (frame.recorded)
+    {
+        TreeDumpRecord& r = frame.record;
+        r.hash = hash;
+        r.id = next_id_++;
+        r.parent = frames_.empty() ? 0 : frames_.back().record.id;
+        r.move = child_move_;
+        r.alpha = alpha;
+        r.beta = beta;
+        r.flags = static_cast<uint16_t>(flags | child_flags_);
+        r.depth = static_cast<int8_t>(depth);
+        r.ply = static_cast<uint8_t>(ply);
+    }
+    child_move_ = 0;
+    child_flags_ = 0;
+    frames_.push_back(frame);
+}
+
+void SearchTreeDump::leave(int result)
+{
+    Frame& frame = frames_.back();
+    if (frame.recorded)
+    {
+        frame.record.result = result;
+        buffer_.push_back(frame.record);
+        if (buffer_.size() >= TREE_DUMP_BUFFER_RECORDS)
+        {
+            flush();
+        }
+    }
+    frames_.pop_back();
+}
+
+void SearchTreeDump::flush()
+{
+    if (!buffer_.empty())
+    {
+        std::fwrite(buffer_.data(), sizeof(TreeDumpRecord), buffer_.size(), file_);
+        buffer_.clear();
+    }
+}
@@ -0,0 +1,169 @@
+/*
+ * File:   SearchTreeDump.h
+ *
+ * Binary dump of the search tree for offline analysis of pruning,
+ * reductions and extensions (read it with scripts/treedump.py).
+ *
+ * Every alphabeta() and quiesce() node becomes one fixed-size record, written
+ * when the node returns (post-order), with the id of its parent so the tree
+ * can be rebuilt. The dump stops recording after a node limit. Like
+ * TREE_STAT(), it is only compiled in when SEARCH_TREE_DUMP is defined
+ * (cmake -Dblunder_SEARCH_TREE_DUMP=ON); otherwise the TREE_DUMP_*() macros
+ * expand to nothing and the search is unchanged.
+ *
+ * File layout (little-endian): the 8-byte magic "BLTREE1\0", a U32 record
+ * size, then TreeDumpRecord structs back to back.
+ */
+
+#ifndef SEARCH_TREE_DUMP_H
+#define SEARCH_TREE_DUMP_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "Constants.h"
+#include "Types.h"
+
+// Node limit of the UCI "treedump" command (40 MB of records)
+constexpr U64 TREE_DUMP_DEFAULT_NODES = 1000000;
+
+/// What happened at a node (flags of the node itself) and why it was
+/// searched (set by its parent just before the call).
+enum TreeDumpFlag : U16
+{
+    TD_QNODE = 1 << 0,            // quiesce() node
+    TD_TT_CUTOFF = 1 << 1,        // returned a hash table score
+    TD_DRAW = 1 << 2,             // returned a draw score
+    TD_NULL_TRY = 1 << 3,         // searched a null move
+    TD_NULL_CUTOFF = 1 << 4,      // null move failed high
+    TD_RFP = 1 << 5,              // reverse futility pruning
+    TD_SINGULAR_TRY = 1 << 6,     // ran a singular verification search
+    TD_SINGULAR_EXT = 1 << 7,     // TT move found singular and extended
+    TD_CHECK_EXT = 1 << 8,        // in check, moves extended
+    TD_BETA_CUTOFF = 1 << 9,      // a move failed high
+    TD_STAND_PAT = 1 << 10,       // quiescence stand-pat cutoff
+    // Why the node was searched
+    TD_NULL_MOVE = 1 << 11,       // the null move search
+    TD_SINGULAR_VERIFY = 1 << 12, // a verification search, TT move excluded
+    TD_LMR = 1 << 13,             // reduced depth
+    TD_ZERO_WINDOW = 1 << 14,     // zero-window scout
+    TD_RESEARCH = 1 << 15,        // re-search after a scout or reduced search beat alpha
+};
+
+/// Moves skipped at a node, counted per reason.
+enum TreeDumpPrune
+{
+    TDP_FUTILITY,
+    TDP_LMP,
+    TDP_SEE,
+    NUM_TREE_DUMP_PRUNES
+};
+
+struct TreeDumpRecord
+{
+    U64 hash;
+    uint32_t id;        // 1-based, in order of entry
+    uint32_t parent;    // 0 for the root
+    uint32_t move;      // move leading here (0 for root, null move, verification)
+    int32_t alpha;      // window on entry
+    int32_t beta;
+    int32_t result;
+    uint16_t flags;     // TreeDumpFlag bits
+    int8_t depth;       // remaining depth (0 in quiescence)
+    uint8_t ply;
+    uint8_t moves_searched;                 // saturating
+    uint8_t prunes[NUM_TREE_DUMP_PRUNES];   // saturating
+};
+static_assert(sizeof(TreeDumpRecord) == 40, "TreeDumpRecord layout is part of the file format");
+
+class SearchTreeDump
+{
+public:
+    ~SearchTreeDump() { close(); }
+
+    /// Start a dump to path, recording at most max_nodes nodes.
+    bool open(const std::string& path, U64 max_nodes);
+    void close();
+    bool is_open() const { return file_ != nullptr; }
+
+    /// Called on entry to alphabeta()/quiesce(). The search calls itself
+    /// once more from inside the recording frame; this returns true for the
+    /// outer call (record the node) and false for the inner one (search it).
+    bool wrap_node()
+    {
+        if (file_ == nullptr)
+        {
+            return false;
+        }
+        wrapped_ = !wrapped_;
+        return wrapped_;
+    }
+
+    void enter(U64 hash, int depth, int ply, int alpha, int beta, uint16_t flags);
+    void leave(int result);
+
+    /// Annotate the current node.
+    void flag(uint16_t f)
+    {
+        if (!frames_.empty())
+        {
+            frames_.back().record.flags |= f;
+        }
+    }
+    void prune(TreeDumpPrune reason)
+    {
+        if (!frames_.empty() && frames_.back().record.prunes[reason] < 255)
+        {
+            frames_.back().record.prunes[reason]++;
+        }
+    }
+    void move_searched()
+    {
+        if (!frames_.empty() && frames_.back().record.moves_searched < 255)
+        {
+            frames_.back().record.moves_searched++;
+        }
+    }
+    /// Move and reason for the next node entered (the parent's next call).
+    void child(U32 move, uint16_t flags)
+    {
+        child_move_ = move;
+        child_flags_ = flags;
+    }
+
+private:
+    struct Frame
+    {
+        TreeDumpRecord record;
+        bool recorded;
+    };
+
+    void flush();
+
+    std::FILE* file_ = nullptr;
+    std::vector<Frame> frames_;
+    std::vector<TreeDumpRecord> buffer_;
+    U64 max_nodes_ = 0;
+    uint32_t next_id_ = 1;
+    bool wrapped_ = false;
+    U32 child_move_ = 0;
+    uint16_t child_flags_ = 0;
+};
+
+#ifdef SEARCH_TREE_DUMP
+constexpr bool SEARCH_TREE_DUMP_ENABLED = true;
+#define TREE_DUMP_FLAG(f) (tree_dump_.is_open() ? tree_dump_.flag(f) : (void)0)
+#define TREE_DUMP_PRUNE(reason) (tree_dump_.is_open() ? tree_dump_.prune(reason) : (void)0)
+#define TREE_DUMP_MOVE() (tree_dump_.is_open() ? tree_dump_.move_searched() : (void)0)
+#define TREE_DUMP_CHILD(move, f) (tree_dump_.is_open() ? tree_dump_.child((move), (f)) : (void)0)
+#else
+constexpr bool SEARCH_TREE_DUMP_ENABLED = false;
+#define TREE_DUMP_FLAG(f) ((void)0)
+#define TREE_DUMP_PRUNE(reason) ((void)0)
+#define TREE_DUMP_MOVE() ((void)0)
+#define TREE_DUMP_CHILD(move, f) ((void)0)
+#endif
+
+#endif /* SEARCH_TREE_DUMP_H */
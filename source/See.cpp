@@ -7,6 +7,8 @@
 
 #include "MoveGenerator.h"
 
+#include "Trace.h"
+
 using std::max;
 
 const int MAX_GAINS_LENGTH = 32;
@@ -98,6 +100,7 @@ U64 MoveGenerator::consider_xrays(const class Board& board, U64 occupied, U8 to)
 // En-passant captures and promotions are handled.
 int MoveGenerator::see(const class Board& board, Move_t move)
 {
+    TRACE_SCOPE(TR_SEE);
     assert(move != 0U);
     int gain[MAX_GAINS_LENGTH], d = 0;
     // cout << Output::board(board);
@@ -183,3 +186,101 @@ int MoveGenerator::see(const class Board& board, Move_t move)
     // cout << "gain_[" << d << "]=" << gain[d] << endl;
     return gain[0];
 }
+
+// Threshold SEE: see(board, move) >= threshold, without building the whole
+// swap list. The exchange is the same as in see(), but a capture is only
+// followed while the outcome is open: after our capture the result is at
+// most the running gain, after theirs at least minus theirs. The first
+// capture that settles the comparison ends the exchange.
+bool MoveGenerator::see_ge(const class Board& board, Move_t move, int threshold)
+{
+    TRACE_SCOPE(TR_SEE);
+    assert(move != 0U);
+
+    U8 to = move_to(move);
+    U8 from = move_from(move);
+    U64 to_bb = 1ULL << to;
+    U8 piece = board[from];
+    U8 capture = board[to];
+    U64 occupied = (board.bitboard(WHITE) | board.bitboard(BLACK));
+    bool promotion_rank = (to_bb & (ROW_8 | ROW_1)) != 0;
+    if (is_ep_capture(move))
+    {
+        U8 captured_sq = (from & 56) | (to & 7);
+        capture = board[captured_sq];
+        occupied ^= 1ULL << captured_sq;
+    }
+
+    // Our capture: the opponent may stand pat
+    int gain = SEE_PIECE_VALUE[capture >> 1];
+    if (promotion_rank && ((piece & (~1)) == PAWN))
+    {
+        U8 promote_to = move_promote_to(move);
+        gain += SEE_PIECE_VALUE[promote_to >> 1] - SEE_PIECE_VALUE[PAWN >> 1];
+        piece = promote_to;
+    }
+    if (gain < threshold)
+    {
+        return false;
+    }
+    // Their recapture, if any, can not promote here: the result is at least
+    // what is left after it
+    if (!promotion_rank && gain - SEE_PIECE_VALUE[piece >> 1] >= threshold)
+    {
+        return true;
+    }
+
+    U64 queens = board.bitboard(WHITE_QUEEN) | board.bitboard(BLACK_QUEEN);
+    U64 diag_sliders = queens | board.bitboard(WHITE_BISHOP) | board.bitboard(BLACK_BISHOP);
+    U64 line_sliders = queens | board.bitboard(WHITE_ROOK) | board.bitboard(BLACK_ROOK);
+    U64 may_xray = diag_sliders | line_sliders | board.bitboard(WHITE_PAWN)
+        | board.bitboard(BLACK_PAWN);
+
+    U64 from_bb = 1ULL << from;
+    U64 attadef = attacks_to(board, occupied, to) | from_bb;
+    U8 attacker_side = board.side_to_move();
+
+    // gain is for the side that made the last capture, d its parity
+    int d = 0;
+    for (;;)
+    {
+        int next_gain = SEE_PIECE_VALUE[piece >> 1] - gain;  // if recaptured
+        if (max(-gain, next_gain) < 0)
+        {
+            break;  // same pruning as see()
+        }
+        attacker_side ^= 1;
+        attadef ^= from_bb;
+        occupied ^= from_bb;
+        if (from_bb & may_xray)
+        {
+            attadef |= ((rook_attacks(occupied, to) & line_sliders)
+                        | (bishop_attacks(occupied, to) & diag_sliders))
+                & occupied;
+        }
+        from_bb = get_least_valuable_piece(board, attadef, attacker_side, piece);
+        if (!from_bb)
+        {
+            break;
+        }
+        if (promotion_rank && ((piece & (~1)) == PAWN))
+        {
+            next_gain += SEE_PIECE_VALUE[QUEEN >> 1] - SEE_PIECE_VALUE[PAWN >> 1];
+            piece = QUEEN;
+        }
+        gain = next_gain;
+        d ^= 1;
+        // Ours can only bring the result down to gain, theirs only up to
+        // -gain: either settles it when it crosses the threshold
+        if (d == 0 && gain < threshold)
+        {
+            return false;
+        }
+        if (d == 1 && -gain >= threshold)
+        {
+            return true;
+        }
+    }
+    // The last capture made stands
+    return d == 0;
+}
@@ -510,7 +510,7 @@ float SelfPlay::play_mcts_game(int simulations,
 
         // Select move and extract policy from visit distribution
         Move_t chosen = select_mcts_move(
-            root.get(), eff_temp, entry.policy, entry.move_indices, entry.num_moves);
+            root.get(), eff_temp, entry.policy, entry.moves, entry.num_moves);
 
         if (chosen == Move(0))
         {
@@ -537,14 +537,14 @@ float SelfPlay::play_mcts_game(int simulations,
 Move_t SelfPlay::select_mcts_move(MCTSNode* root,
                                   double temperature,
                                   float policy_out[256],
-                                  int move_indices_out[256],
+                                  PackedMove moves_out[256],
                                   int& num_moves)
 {
     // Zero out policy
     for (int i = 0; i < 256; ++i)
     {
         policy_out[i] = 0.0f;
-        move_indices_out[i] = 0;
+        moves_out[i] = PackedMove();
     }
 
     int n = static_cast<int>(root->children.size());
@@ -563,8 +563,7 @@ Move_t SelfPlay::select_mcts_move(MCTSNode* root,
         visits[static_cast<size_t>(i)] =
             static_cast<double>(root->children[static_cast<size_t>(i)]->visits);
         total_visits += root->children[static_cast<size_t>(i)]->visits;
-        Move_t m = root->children[static_cast<size_t>(i)]->move;
-        move_indices_out[i] = m.from() * 64 + m.to();
+        moves_out[i] = pack_move(root->children[static_cast<size_t>(i)]->move);
     }
 
     if (total_visits == 0)
@@ -660,6 +659,12 @@ void SelfPlay::add_dirichlet_noise(MCTSNode* root, double alpha, double epsilon)
     }
 }
 
+// MCTS training files start with this magic and a U32 format version.
+// Version 1 files have no header and store each move as a 32-bit
+// from*64+to index; version 2 stores 16-bit PackedMoves.
+static constexpr char MCTS_TRAINING_MAGIC[8] = { 'B', 'L', 'M', 'C', 'T', 'S', '\0', '\0' };
+static constexpr uint32_t MCTS_TRAINING_VERSION = 2;
+
 void SelfPlay::write_mcts_training_data(const std::vector<MCTSTrainingEntry>& entries,
                                         const std::string& output_path)
 {
@@ -670,12 +675,15 @@ void SelfPlay::write_mcts_training_data(const std::vector<MCTSTrainingEntry>& en
         return;
     }
 
-    // File format (per entry):
+    // File format: the 8-byte magic and a U32 version, then per entry:
     //   768 floats: features
     //   1 int:      num_moves
     //   num_moves floats: policy (normalized visit distribution)
-    //   num_moves ints:   move_indices (from*64+to encoding)
+    //   num_moves U16s:   moves (PackedMove, see Move.h)
     //   1 float:   value (game outcome)
+    out.write(MCTS_TRAINING_MAGIC, sizeof(MCTS_TRAINING_MAGIC));
+    out.write(reinterpret_cast<const char*>(&MCTS_TRAINING_VERSION),
+              sizeof(MCTS_TRAINING_VERSION));
     for (const auto& entry : entries)
     {
         out.write(reinterpret_cast<const char*>(entry.features), sizeof(entry.features));
@@ -683,8 +691,9 @@ void SelfPlay::write_mcts_training_data(const std::vector<MCTSTrainingEntry>& en
         out.write(
             reinterpret_cast<const char*>(entry.policy),
             static_cast<std::streamsize>(static_cast<size_t>(entry.num_moves) * sizeof(float)));
-        out.write(reinterpret_cast<const char*>(entry.move_indices),
-                  static_cast<std::streamsize>(static_cast<size_t>(entry.num_moves) * sizeof(int)));
+        out.write(reinterpret_cast<const char*>(entry.moves),
+                  static_cast<std::streamsize>(static_cast<size_t>(entry.num_moves)
+                                               * sizeof(PackedMove)));
         out.write(reinterpret_cast<const char*>(&entry.value), sizeof(entry.value));
     }
 
@@ -40,7 +40,7 @@ struct MCTSTrainingEntry
     float policy[256];     // Visit count distribution over moves (padded, normalized)
     float value;           // Game outcome: +1=win, 0=draw, -1=loss (side-to-move)
     int num_moves;         // Number of legal moves (valid entries in policy[])
-    int move_indices[256]; // Move encoding for each policy slot (from*64+to)
+    PackedMove moves[256]; // Move of each policy slot
 };
 
 class SelfPlay
@@ -108,7 +108,7 @@ private:
     Move_t select_mcts_move(MCTSNode* root,
                             double temperature,
                             float policy_out[256],
-                            int move_indices_out[256],
+                            PackedMove moves_out[256],
                             int& num_moves);
 
     /// Add Dirichlet noise to root node priors.
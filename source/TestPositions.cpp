@@ -1,14 +1,20 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <thread>
 
 #include "TestPositions.h"
 
 #include "CLIUtils.h"
+#include "CoachJson.h"
 #include "Move.h"
 #include "MoveGenerator.h"
+#include "Output.h"
 #include "Parser.h"
 #include "Search.h"
 
@@ -24,8 +30,6 @@ using std::vector;
 // Test positions
 // https://www.chessprogramming.org/Test-Positions
 
-const int TEST_POSITIONS_MAX_NODES_VISITED = 1000000;
-
 double test_positions(string path_to_epd)
 {
     std::ifstream infile(path_to_epd);
@@ -38,8 +42,8 @@ double test_positions(string path_to_epd)
     std::string line;
     int score = 0;
     int max_score = 0;
-    long long total_nodes = 0;
-    clock_t wall_start = clock();
+    U64 total_nodes = 0;
+    auto wall_start = std::chrono::steady_clock::now();
     while (std::getline(infile, line))
     {
         std::istringstream iss(line);
@@ -122,6 +126,7 @@ double test_positions(string path_to_epd)
 
         // Search with max depth, infinite time, max 1000000 moves searched
         Search search(board);
+        search.set_abort(false);
         Move_t move = search.search(MAX_SEARCH_PLY, -1, TEST_POSITIONS_MAX_NODES_VISITED);
         total_nodes += search.get_stats().nodes_visited;
         for (auto best_move : best_moves)
@@ -141,8 +146,8 @@ double test_positions(string path_to_epd)
          << max_score << ")" << endl;
     cout << "ELO=" << int(elo_estimate) << endl;
 
-    clock_t wall_end = clock();
-    double total_time_secs = static_cast<double>(wall_end - wall_start) / CLOCKS_PER_SEC;
+    double total_time_secs =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
     int nps = (total_time_secs > 0.0)
         ? static_cast<int>(static_cast<double>(total_nodes) / total_time_secs)
         : 0;
@@ -155,11 +160,10 @@ double test_positions(string path_to_epd)
 
 double test_positions_benchmark(string path_to_epd)
 {
-    clock_t tic = clock();
+    auto tic = std::chrono::steady_clock::now();
     double score = test_positions(path_to_epd);
-    clock_t toc = clock();
-
-    long double elapsed_secs = static_cast<long double>(toc - tic) / CLOCKS_PER_SEC;
+    double elapsed_secs =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - tic).count();
     cout << "time: " << elapsed_secs << "s" << endl;
     return score;
 }
@@ -247,85 +251,159 @@ static bool parse_best_moves(Board& board, vector<tuple<Move_t, int>>& best_move
     return true;
 }
 
-BenchmarkResult test_positions_ex(const string& path_to_epd, SearchMode mode, int param)
+static PositionRecord test_position(const string& line, SearchMode mode, int param, bool silent)
+{
+    PositionRecord pr;
+    Board board = Parser::parse_epd(line);
+    pr.id = board.epd_op("id");
+    if (pr.id.size() >= 2 && pr.id.front() == '"' && pr.id.back() == '"')
+    {
+        pr.id = pr.id.substr(1, pr.id.size() - 2);
+    }
+    pr.category = extract_category(pr.id);
+
+    vector<tuple<Move_t, int>> best_moves;
+    int line_max = 0;
+    if (!parse_best_moves(board, best_moves, line_max))
+    {
+        return pr;
+    }
+    pr.valid = true;
+    pr.max_score = std::get<1>(best_moves[0]);  // max is first entry
+    for (const auto& bm : best_moves)
+    {
+        pr.expected.push_back({ Output::move(std::get<0>(bm), board), std::get<1>(bm) });
+    }
+
+    // Search based on mode
+    Search search(board);
+    if (silent)
+    {
+        search.set_output_mode(Search::OutputMode::SILENT);
+    }
+    search.set_abort(false);
+    auto start = std::chrono::steady_clock::now();
+    Move_t move = 0;
+    switch (mode)
+    {
+        case SearchMode::FixedNodes:
+            move = search.search(MAX_SEARCH_PLY, -1, param);
+            break;
+        case SearchMode::FixedDepth:
+            search.get_tm().start(-1, -1);  // depth is the only limit
+            move = search.search(param, -1, -1);
+            break;
+        case SearchMode::FixedTime:
+            // param is milliseconds, search() expects microseconds
+            move = search.search(MAX_SEARCH_PLY, param * 1000, -1);
+            break;
+    }
+    pr.time_secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const SearchStats& stats = search.get_stats();
+    pr.nodes = static_cast<long long>(stats.nodes_visited);
+    pr.hash_probes = static_cast<long long>(stats.hash_probes);
+    pr.hash_hits = static_cast<long long>(stats.hash_hits);
+    pr.depth = search.get_completed_depth();
+    pr.move = (move != 0U) ? Output::move(move, board) : "";
+
+    for (const auto& bm : best_moves)
+    {
+        if (move == std::get<0>(bm))
+        {
+            pr.score = std::get<1>(bm);
+            break;
+        }
+    }
+    return pr;
+}
+
+BenchmarkResult test_positions_ex(
+    const string& path_to_epd, SearchMode mode, int param, int jobs, bool quiet)
 {
     BenchmarkResult result;
 
     ifstream infile(path_to_epd);
     if (!infile.is_open())
     {
-        cout << "Error: Could not open " << path_to_epd << endl;
+        if (!quiet)
+        {
+            cout << "Error: Could not open " << path_to_epd << endl;
+        }
         return result;
     }
 
-    clock_t wall_start = clock();
+    vector<string> lines;
     string line;
-
     while (std::getline(infile, line))
     {
-        Board board = Parser::parse_epd(line);
-
-        // Extract category from id field
-        string id_str = board.epd_op("id");
-        string category = extract_category(id_str);
-
-        // Parse best moves
-        vector<tuple<Move_t, int>> best_moves;
-        int line_max = 0;
-        if (!parse_best_moves(board, best_moves, line_max))
+        if (!line.empty())
         {
-            cout << "Error: No best move found in: " << id_str << endl;
-            continue;
+            lines.push_back(line);
         }
-        result.max_score += line_max;
+    }
+    if (lines.empty())
+    {
+        return result;
+    }
 
-        // Search based on mode
-        Search search(board);
-        Move_t move = 0;
-        switch (mode)
+    int n = static_cast<int>(lines.size());
+    jobs = std::max(1, std::min(jobs, n));
+    result.positions.resize(lines.size());
+
+    // Board::reset() runs the one-time table initialization; do it here,
+    // before any worker thread parses a position.
+    Parser::parse_fen(DEFAULT_FEN);
+
+    auto wall_start = std::chrono::steady_clock::now();
+    std::atomic<int> next_position {0};
+    auto worker = [&]()
+    {
+        int i;
+        while ((i = next_position.fetch_add(1)) < n)
         {
-            case SearchMode::FixedNodes:
-                move = search.search(MAX_SEARCH_PLY, -1, param);
-                break;
-            case SearchMode::FixedDepth:
-                move = search.search(param, -1, -1);
-                break;
-            case SearchMode::FixedTime:
-                // param is milliseconds, search() expects microseconds
-                move = search.search(MAX_SEARCH_PLY, param * 1000, -1);
-                break;
+            // Iteration output would interleave across jobs
+            result.positions[static_cast<size_t>(i)] =
+                test_position(lines[static_cast<size_t>(i)], mode, param, quiet || jobs > 1);
         }
+    };
+    vector<std::thread> pool;
+    for (int t = 1; t < jobs; t++)
+    {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : pool)
+    {
+        thread.join();
+    }
+    result.total_time_secs =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
 
-        result.total_nodes += search.get_stats().nodes_visited;
-
-        // Score the move
-        int move_score = 0;
-        for (const auto& bm : best_moves)
+    for (const PositionRecord& pr : result.positions)
+    {
+        if (!pr.valid)
         {
-            if (move == std::get<0>(bm))
+            if (!quiet)
             {
-                move_score = std::get<1>(bm);
-                break;
+                cout << "Error: No best move found in: " << pr.id << endl;
             }
+            continue;
         }
-        result.score += move_score;
+        result.max_score += pr.max_score;
+        result.score += pr.score;
+        result.total_nodes += pr.nodes;
 
         // Track per-category
-        if (!category.empty())
+        if (!pr.category.empty())
         {
-            auto& cat = result.categories[category];
-            cat.score += move_score;
-            if (!best_moves.empty())
-            {
-                cat.max_score += std::get<1>(best_moves[0]);  // max is first entry
-            }
+            auto& cat = result.categories[pr.category];
+            cat.score += pr.score;
+            cat.max_score += pr.max_score;
             cat.positions++;
         }
     }
 
-    clock_t wall_end = clock();
-    result.total_time_secs = static_cast<double>(wall_end - wall_start) / CLOCKS_PER_SEC;
-
     if (result.max_score > 0)
     {
         result.score_pct = (100.0 * result.score) / result.max_score;
@@ -337,6 +415,11 @@ BenchmarkResult test_positions_ex(const string& path_to_epd, SearchMode mode, in
             static_cast<int>(static_cast<double>(result.total_nodes) / result.total_time_secs);
     }
 
+    if (quiet)
+    {
+        return result;
+    }
+
     // Print summary
     cout << "Score=" << std::fixed << setprecision(2) << result.score_pct << "% (" << result.score
          << "/" << result.max_score << ")" << endl;
@@ -359,3 +442,79 @@ BenchmarkResult test_positions_ex(const string& path_to_epd, SearchMode mode, in
 
     return result;
 }
+
+string test_positions_json(const BenchmarkResult& result)
+{
+    using CoachJson::to_json;
+
+    long long hash_probes = 0;
+    long long hash_hits = 0;
+    double depth_sum = 0.0;
+    int searched = 0;
+    vector<string> positions;
+    for (const PositionRecord& pr : result.positions)
+    {
+        vector<string> expected;
+        for (const auto& [move, score] : pr.expected)
+        {
+            expected.push_back(CoachJson::object({ { "move", to_json(move) },
+                                                   { "score", to_json(score) } }));
+        }
+        double hit_rate = (pr.hash_probes > 0)
+            ? static_cast<double>(pr.hash_hits) / static_cast<double>(pr.hash_probes)
+            : 0.0;
+        positions.push_back(CoachJson::object({
+            { "id", to_json(pr.id) },
+            { "category", to_json(pr.category) },
+            { "valid", to_json(pr.valid) },
+            { "move", pr.valid ? to_json(pr.move) : CoachJson::to_json_null() },
+            { "expected", CoachJson::array(expected) },
+            { "score", to_json(pr.score) },
+            { "max_score", to_json(pr.max_score) },
+            { "nodes", std::to_string(pr.nodes) },
+            { "time_secs", to_json(pr.time_secs) },
+            { "depth", to_json(pr.depth) },
+            { "tt_hit_rate", to_json(hit_rate) },
+        }));
+
+        if (pr.valid)
+        {
+            hash_probes += pr.hash_probes;
+            hash_hits += pr.hash_hits;
+            depth_sum += pr.depth;
+            searched++;
+        }
+    }
+
+    // object() writes keys verbatim: escape category names like any string
+    vector<std::pair<string, string>> categories;
+    for (const auto& [name, cat] : result.categories)
+    {
+        string key = to_json(name);
+        categories.push_back({ key.substr(1, key.size() - 2),
+                               CoachJson::object({ { "score", to_json(cat.score) },
+                                                   { "max_score", to_json(cat.max_score) },
+                                                   { "positions", to_json(cat.positions) } }) });
+    }
+
+    string summary = CoachJson::object({
+        { "positions", to_json(static_cast<int>(result.positions.size())) },
+        { "searched", to_json(searched) },
+        { "score_pct", to_json(result.score_pct) },
+        { "score", to_json(result.score) },
+        { "max_score", to_json(result.max_score) },
+        { "elo", to_json(result.elo) },
+        { "nodes", std::to_string(result.total_nodes) },
+        { "time_secs", to_json(result.total_time_secs) },
+        { "nps", to_json(result.nps) },
+        { "mean_depth", to_json(searched > 0 ? depth_sum / searched : 0.0) },
+        { "tt_hit_rate",
+          to_json(hash_probes > 0
+                      ? static_cast<double>(hash_hits) / static_cast<double>(hash_probes)
+                      : 0.0) },
+    });
+
+    return CoachJson::object({ { "summary", summary },
+                               { "categories", CoachJson::object(categories) },
+                               { "positions", CoachJson::array(positions) } });
+}
@@ -9,10 +9,15 @@
 
 #include <map>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "Common.h"
 #include "Board.h"
 
+// Node limit of test_positions() and of SearchMode::FixedNodes by default
+constexpr int TEST_POSITIONS_MAX_NODES_VISITED = 1000000;
+
 // Search mode for test positions
 enum class SearchMode
 {
@@ -29,6 +34,23 @@ struct CategoryResult
     int positions = 0;
 };
 
+// Outcome of one EPD position
+struct PositionRecord
+{
+    bool valid = false;      // the line had usable bm/c0 opcodes
+    std::string id;
+    std::string category;
+    std::string move;        // move played, coordinate notation
+    std::vector<std::pair<std::string, int>> expected;  // best moves and their scores
+    int score = 0;           // score of the move played
+    int max_score = 0;       // score of the best move
+    long long nodes = 0;
+    double time_secs = 0.0;
+    int depth = 0;           // deepest completed iteration
+    long long hash_probes = 0;
+    long long hash_hits = 0;
+};
+
 // Full benchmark result
 struct BenchmarkResult
 {
@@ -40,13 +62,26 @@ struct BenchmarkResult
     double total_time_secs = 0.0;
     int nps = 0;
     std::map<std::string, CategoryResult> categories;  // STS per-category
+    std::vector<PositionRecord> positions;             // in file order
 };
 
 double test_positions(std::string path_to_epd);
 double test_positions_benchmark(std::string path_to_epd);
 
+/// Search every position of an EPD suite and score the moves against its
+/// bm/c0 opcodes. With jobs > 1 the positions are spread over worker threads,
+/// each position still searched with its own Board, hash table and Search;
+/// the results are merged in file order, so at fixed depth or nodes they do
+/// not depend on the job count. Time is wall-clock. quiet suppresses all
+/// output (search iterations and the summary).
 BenchmarkResult test_positions_ex(const std::string& path_to_epd,
                                   SearchMode mode,
-                                  int param);  // depth or time_ms or nodes
+                                  int param,  // depth or time_ms or nodes
+                                  int jobs = 1,
+                                  bool quiet = false);
+
+/// Serialize a result as one JSON object: summary, categories and the
+/// per-position records.
+std::string test_positions_json(const BenchmarkResult& result);
 
 #endif /* TEST_POSITIONS_H */
@@ -9,6 +9,7 @@
  *   - Instability detection: extend time when best move changes
  *   - Score-based adjustment: reduce time when clearly winning/losing
  *   - Hard limit is never exceeded
+ *   - ponderhit() converts an infinite ponder search into a timed one
  *
  * Uses std::chrono::steady_clock for wall-time measurement (not CPU time).
  * This is critical for UCI time management where wtime/btime are wall-clock.
@@ -34,50 +35,7 @@ public:
     /// @param moves_to_go   Moves until next time control (0 = sudden death)
     void allocate(int time_left_cs, int inc_cs, int moves_to_go)
     {
-        // Convert to microseconds for internal use
-        int time_left_us = time_left_cs * 10000;
-        int inc_us = inc_cs * 10000;
-
-        // Estimate moves remaining: use moves_to_go if set, otherwise assume 30
-        int moves_est = (moves_to_go > 0) ? (std::max)(moves_to_go, 1) : 30;
-
-        // Base time: fraction of remaining time + 3/4 of increment
-        int base = time_left_us / moves_est + inc_us * 3 / 4;
-
-        // Safety margin: never use more than 90% of remaining time
-        int max_allowed = time_left_us * 9 / 10;
-
-        // Ensure max_allowed is at least a small amount if we have any time
-        if (max_allowed < 100000 && time_left_us > 100000)
-        {
-            max_allowed = 100000;  // 0.1s floor
-        }
-
-        // Clamp base to max_allowed
-        if (base > max_allowed)
-        {
-            base = max_allowed;
-        }
-
-        // Ensure base is at least 0.1s if we have time
-        if (base < 100000 && time_left_us > 100000)
-        {
-            base = 100000;
-        }
-        else if (base < 0)
-        {
-            base = 100000;
-        }
-
-        soft_limit_ = base;
-
-        // Hard limit: 2x soft limit, but never more than 1/4 of remaining time
-        int quarter_time = time_left_us / 4;
-        hard_limit_ = (std::min)(soft_limit_ * 2, (std::min)(max_allowed, quarter_time));
-        if (hard_limit_ < soft_limit_)
-        {
-            hard_limit_ = soft_limit_;
-        }
+        compute_limits(time_left_cs, inc_cs, moves_to_go);
 
         start_ = Clock::now();
         max_nodes_ = -1;
@@ -85,6 +43,20 @@ public:
         easy_move_applied_ = false;
     }
 
+    /// Ponderhit: turn a running infinite (ponder) search into a timed one
+    /// without restarting it. Our clock only started running now, so the
+    /// hard limit is measured from now; the soft limit also counts the time
+    /// already spent pondering, so a long ponder lets the engine move at the
+    /// end of the current iteration.
+    void ponderhit(int time_left_cs, int inc_cs, int moves_to_go)
+    {
+        int pondered_us = elapsed_us();
+        compute_limits(time_left_cs, inc_cs, moves_to_go);
+        hard_limit_ += pondered_us;
+        score_adjusted_ = false;
+        easy_move_applied_ = false;
+    }
+
     /// Legacy start method for non-clock-based searches (fixed time, node limit).
     void start(int search_time, int max_nodes = -1)
     {
@@ -108,10 +80,12 @@ public:
     }
 
     /// Reduce soft limit when position is clearly won or lost.
+    /// Only applies when a real time limit is set (infinite/ponder searches
+    /// keep soft_limit_ == -1 until a ponderhit).
     /// @param score_cp  Score in centipawns from side-to-move perspective
     void adjust_for_score(int score_cp)
     {
-        if (!score_adjusted_ && (score_cp > 500 || score_cp < -500))
+        if (!score_adjusted_ && soft_limit_ > 0 && (score_cp > 500 || score_cp < -500))
         {
             soft_limit_ = soft_limit_ * 3 / 5;
             score_adjusted_ = true;
@@ -138,10 +112,18 @@ public:
             std::chrono::duration_cast<std::chrono::microseconds>(now - start_).count());
     }
 
-    /// Called every 2048 nodes in alphabeta/quiesce to check hard time limit.
-    bool is_time_over(int nodes_visited) const
+    /// True once the node budget is exhausted. Cheap (no clock read), so
+    /// alphabeta/quiesce can call it periodically; the hard time limit is
+    /// enforced by SearchTimer.
+    bool node_limit_reached(U64 nodes_visited) const
+    {
+        return over_node_budget(nodes_visited);
+    }
+
+    /// Check node budget and hard time limit (polled by MCTS between simulations).
+    bool is_time_over(U64 nodes_visited) const
     {
-        if ((max_nodes_ != -1) && (nodes_visited > max_nodes_))
+        if (over_node_budget(nodes_visited))
         {
             return true;
         }
@@ -157,9 +139,9 @@ public:
 
     /// Called between iterative deepening iterations to decide whether
     /// there is enough time for another depth.
-    bool should_stop(int nodes_visited) const
+    bool should_stop(U64 nodes_visited) const
     {
-        if ((max_nodes_ != -1) && (nodes_visited > max_nodes_))
+        if (over_node_budget(nodes_visited))
         {
             return true;
         }
@@ -179,6 +161,61 @@ public:
     int hard_limit() const { return hard_limit_; }
 
 private:
+    bool over_node_budget(U64 nodes_visited) const
+    {
+        return (max_nodes_ != -1) && (nodes_visited > static_cast<U64>(max_nodes_));
+    }
+
+    /// Soft and hard limits for a move from clock state (shared by allocate
+    /// and ponderhit). Limits are relative to the moment of the call.
+    void compute_limits(int time_left_cs, int inc_cs, int moves_to_go)
+    {
+        // Convert to microseconds for internal use
+        int time_left_us = time_left_cs * 10000;
+        int inc_us = inc_cs * 10000;
+
+        // Estimate moves remaining: use moves_to_go if set, otherwise assume 30
+        int moves_est = (moves_to_go > 0) ? (std::max)(moves_to_go, 1) : 30;
+
+        // Base time: fraction of remaining time + 3/4 of increment
+        int base = time_left_us / moves_est + inc_us * 3 / 4;
+
+        // Safety margin: never use more than 90% of remaining time
+        int max_allowed = time_left_us * 9 / 10;
+
+        // Ensure max_allowed is at least a small amount if we have any time
+        if (max_allowed < 100000 && time_left_us > 100000)
+        {
+            max_allowed = 100000;  // 0.1s floor
+        }
+
+        // Clamp base to max_allowed
+        if (base > max_allowed)
+        {
+            base = max_allowed;
+        }
+
+        // Ensure base is at least 0.1s if we have time
+        if (base < 100000 && time_left_us > 100000)
+        {
+            base = 100000;
+        }
+        else if (base < 0)
+        {
+            base = 100000;
+        }
+
+        soft_limit_ = base;
+
+        // Hard limit: 2x soft limit, but never more than 1/4 of remaining time
+        int quarter_time = time_left_us / 4;
+        hard_limit_ = (std::min)(soft_limit_ * 2, (std::min)(max_allowed, quarter_time));
+        if (hard_limit_ < soft_limit_)
+        {
+            hard_limit_ = soft_limit_;
+        }
+    }
+
     TimePoint start_ = Clock::now();
     int search_time_ = DEFAULT_SEARCH_TIME;
     int soft_limit_ = DEFAULT_SEARCH_TIME;
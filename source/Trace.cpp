@@ -0,0 +1,85 @@
+/*
+ * File:   Trace.cpp
+ *
+ */
+
+#include <atomic>
+#include <iomanip>
+#include <string>
+
+#include "Trace.h"
+
+namespace Trace
+{
+static std::atomic<U64> total_calls[NUM_TRACE_IDS];
+static std::atomic<U64> total_ticks[NUM_TRACE_IDS];
+
+static void flush(Counters& c)
+{
+    for (int i = 0; i < NUM_TRACE_IDS; i++)
+    {
+        total_calls[i].fetch_add(c.calls[i], std::memory_order_relaxed);
+        total_ticks[i].fetch_add(c.ticks[i], std::memory_order_relaxed);
+        c.calls[i] = 0;
+        c.ticks[i] = 0;
+    }
+}
+
+Counters::~Counters()
+{
+    flush(*this);
+}
+
+void reset()
+{
+    for (int i = 0; i < NUM_TRACE_IDS; i++)
+    {
+        counters.calls[i] = 0;
+        counters.ticks[i] = 0;
+        total_calls[i].store(0, std::memory_order_relaxed);
+        total_ticks[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void print(std::ostream& os)
+{
+    if (!TRACING)
+    {
+        os << "hot-path tracing not compiled in (configure with -Dblunder_TRACE=ON)" << std::endl;
+        return;
+    }
+
+    const char* names[NUM_TRACE_IDS] = {
+        "do_move", "undo_move", "add_all_moves", "add_loud_moves", "see",
+        "hce evaluate", "nnue forward", "nnue refresh", "tt probe", "tt record",
+    };
+#ifdef TRACE_HAS_TSC
+    const char* unit = "cycles";
+#else
+    const char* unit = "ns";
+#endif
+
+    flush(counters);
+    U64 sum = 0;
+    for (int i = 0; i < NUM_TRACE_IDS; i++)
+    {
+        sum += total_ticks[i].load(std::memory_order_relaxed);
+    }
+
+    os << std::left << std::setw(16) << "function" << std::right << std::setw(14) << "calls"
+       << std::setw(18) << (std::string("total ") + unit) << std::setw(12) << "per call"
+       << std::setw(9) << "share" << std::endl;
+    for (int i = 0; i < NUM_TRACE_IDS; i++)
+    {
+        U64 calls = total_calls[i].load(std::memory_order_relaxed);
+        U64 ticks = total_ticks[i].load(std::memory_order_relaxed);
+        os << std::left << std::setw(16) << names[i] << std::right << std::setw(14) << calls
+           << std::setw(18) << ticks << std::setw(12) << std::fixed << std::setprecision(1)
+           << (calls > 0 ? static_cast<double>(ticks) / static_cast<double>(calls) : 0.0)
+           << std::setw(8)
+           << (sum > 0 ? 100.0 * static_cast<double>(ticks) / static_cast<double>(sum) : 0.0)
+           << "%" << std::endl;
+    }
+    os << std::defaultfloat << "(times are inclusive: do_move includes nnue refresh)" << std::endl;
+}
+}  // namespace Trace
@@ -0,0 +1,108 @@
+/*
+ * File:   Trace.h
+ *
+ * Hot-path tracing: call counts and time (TSC cycles on x86, nanoseconds
+ * elsewhere) of a few engine primitives, measured in the build being run.
+ *
+ * TRACE_SCOPE(id) at the top of a function times the rest of the scope with
+ * an RAII timer. Like TREE_STAT(), it is only compiled in when BLUNDER_TRACE
+ * is defined (cmake -Dblunder_TRACE=ON); otherwise it expands to nothing.
+ * Times are inclusive: do_move includes the NNUE refresh it triggers.
+ *
+ * Counters are thread-local and folded into the global totals when a thread
+ * exits or the totals are printed, so timers cost no synchronization.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <chrono>
+#include <ostream>
+
+#include "Types.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define TRACE_HAS_TSC 1
+#endif
+
+/// Traced functions.
+enum TraceId
+{
+    TR_DO_MOVE,
+    TR_UNDO_MOVE,
+    TR_ALL_MOVES,      // MoveGenerator::add_all_moves
+    TR_LOUD_MOVES,     // MoveGenerator::add_loud_moves
+    TR_SEE,
+    TR_HCE_EVAL,       // HandCraftedEvaluator::evaluate
+    TR_NNUE_FORWARD,
+    TR_NNUE_REFRESH,
+    TR_TT_PROBE,
+    TR_TT_RECORD,
+    NUM_TRACE_IDS
+};
+
+namespace Trace
+{
+struct Counters
+{
+    U64 calls[NUM_TRACE_IDS] = {};
+    U64 ticks[NUM_TRACE_IDS] = {};
+
+    ~Counters();  // folds this thread's counts into the totals
+};
+
+inline thread_local Counters counters;
+
+inline U64 now()
+{
+#ifdef TRACE_HAS_TSC
+    return static_cast<U64>(__rdtsc());
+#else
+    return static_cast<U64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::steady_clock::now().time_since_epoch())
+                                .count());
+#endif
+}
+
+class ScopedTimer
+{
+public:
+    explicit ScopedTimer(TraceId id) : id_(id), start_(now()) {}
+    ~ScopedTimer()
+    {
+        counters.calls[id_]++;
+        counters.ticks[id_] += now() - start_;
+    }
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    TraceId id_;
+    U64 start_;
+};
+
+/// Zero the totals and the calling thread's counters.
+void reset();
+
+/// Print calls, total and per-call time and share per traced function,
+/// summed over exited threads and the calling thread.
+void print(std::ostream& os);
+}  // namespace Trace
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+
+#ifdef BLUNDER_TRACE
+constexpr bool TRACING = true;
+#define TRACE_SCOPE(id) Trace::ScopedTimer TRACE_CONCAT(trace_scope_, __LINE__)(id)
+#else
+constexpr bool TRACING = false;
+#define TRACE_SCOPE(id) ((void)0)
+#endif
+
+#endif /* TRACE_H */
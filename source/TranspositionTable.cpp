@@ -6,6 +6,8 @@
 
 #include "TranspositionTable.h"
 
+#include "Trace.h"
+
 size_t TranspositionTable::to_power_of_two(size_t n)
 {
     if (n == 0)
@@ -46,11 +48,10 @@ void TranspositionTable::clear()
     for (auto& entry : table_)
     {
         entry.key = 0;
-        entry.depth = 0;
-        entry.flags = 0;
         entry.value = 0;
-        entry.best_move = 0U;
-        entry.generation = 0;
+        entry.best_move = PackedMove();
+        entry.depth = 0;
+        entry.flags_generation = 0;
     }
     generation_ = 0;
 }
@@ -68,7 +69,8 @@ void TranspositionTable::resize(int size_mb)
     {
         actual = 1;
     }
-    table_.resize(actual);
+    // A fresh vector, so that shrinking the table also releases its memory
+    table_ = std::vector<HASHE>(actual);
     mask_ = actual - 1;
     clear();
 }
@@ -77,11 +79,12 @@ int TranspositionTable::probe(U64 hash,
                               int depth,
                               int alpha,
                               int beta,
-                              Move_t& best_move,
+                              PackedMove& best_move,
                               int* tt_depth_out,
                               int* tt_flags_out,
                               int* tt_value_out)
 {
+    TRACE_SCOPE(TR_TT_PROBE);
     HASHE* phashe = &table_[hash & mask_];
 
     if (phashe->key == hash)
@@ -92,9 +95,10 @@ int TranspositionTable::probe(U64 hash,
         {
             *tt_depth_out = phashe->depth;
         }
+        int flags = phashe->flags();
         if (tt_flags_out)
         {
-            *tt_flags_out = phashe->flags;
+            *tt_flags_out = flags;
         }
         if (tt_value_out)
         {
@@ -103,15 +107,15 @@ int TranspositionTable::probe(U64 hash,
 
         if (phashe->depth >= depth)
         {
-            if (phashe->flags == HASH_EXACT)
+            if (flags == HASH_EXACT)
             {
                 return phashe->value;
             }
-            if ((phashe->flags == HASH_ALPHA) && (phashe->value <= alpha))
+            if ((flags == HASH_ALPHA) && (phashe->value <= alpha))
             {
                 return alpha;
             }
-            if ((phashe->flags == HASH_BETA) && (phashe->value >= beta))
+            if ((flags == HASH_BETA) && (phashe->value >= beta))
             {
                 return beta;
             }
@@ -121,8 +125,9 @@ int TranspositionTable::probe(U64 hash,
     return UNKNOWN_SCORE;
 }
 
-void TranspositionTable::record(U64 hash, int depth, int val, int flags, Move_t best_move)
+void TranspositionTable::record(U64 hash, int depth, int val, int flags, PackedMove best_move)
 {
+    TRACE_SCOPE(TR_TT_RECORD);
     HASHE* phashe = &table_[hash & mask_];
 
     // Depth-preferred replacement with aging:
@@ -130,7 +135,7 @@ void TranspositionTable::record(U64 hash, int depth, int val, int flags, Move_t
     // 2. Stale entry (different generation): always replace
     // 3. Same generation, new depth >= existing depth: replace
     // 4. Same generation, new depth < existing depth: keep existing
-    if (phashe->key != 0 && phashe->generation == generation_ && depth < phashe->depth)
+    if (phashe->key != 0 && phashe->generation() == generation_ && depth < phashe->depth)
     {
         return;  // keep the deeper same-generation entry
     }
@@ -138,7 +143,6 @@ void TranspositionTable::record(U64 hash, int depth, int val, int flags, Move_t
     phashe->key = hash;
     phashe->best_move = best_move;
     phashe->value = val;
-    phashe->flags = flags;
-    phashe->depth = depth;
-    phashe->generation = generation_;
+    phashe->depth = static_cast<int8_t>(depth);
+    phashe->flags_generation = static_cast<uint8_t>(flags | (generation_ << 2));
 }
@@ -20,14 +20,20 @@ constexpr int HASH_EXACT = 0;
 constexpr int HASH_ALPHA = 1;
 constexpr int HASH_BETA  = 2;
 
+/// One 16-byte entry: four per cache line.
 struct HASHE {
     U64 key;
-    int depth;
-    int flags;
-    int value;
-    Move_t best_move;
-    uint8_t generation;
+    int32_t value;
+    PackedMove best_move;
+    int8_t depth;
+    uint8_t flags_generation;  // HASH_* in bits 0-1, generation in bits 2-7
+
+    int flags() const { return flags_generation & 3; }
+    uint8_t generation() const { return static_cast<uint8_t>(flags_generation >> 2); }
 };
+static_assert(sizeof(HASHE) == 16, "HASHE should stay 16 bytes");
+
+constexpr int TT_GENERATION_MASK = 0x3F;
 
 class TranspositionTable {
 public:
@@ -35,12 +41,15 @@ public:
 
     void clear();
     void resize(int size_mb);
-    void new_generation() { generation_ = static_cast<uint8_t>((generation_ + 1) & 0xFF); }
+    void new_generation()
+    {
+        generation_ = static_cast<uint8_t>((generation_ + 1) & TT_GENERATION_MASK);
+    }
     uint8_t generation() const { return generation_; }
-    int probe(U64 hash, int depth, int alpha, int beta, Move_t& best_move,
+    int probe(U64 hash, int depth, int alpha, int beta, PackedMove& best_move,
              int* tt_depth_out = nullptr, int* tt_flags_out = nullptr,
              int* tt_value_out = nullptr);
-    void record(U64 hash, int depth, int val, int flags, Move_t best_move);
+    void record(U64 hash, int depth, int val, int flags, PackedMove best_move);
 
 private:
     std::vector<HASHE> table_;
@@ -11,6 +11,7 @@
 
 #include "UCI.h"
 
+#include "Bench.h"
 #include "MCTS.h"
 #include "Output.h"
 #include "Parser.h"
@@ -25,11 +26,7 @@ UCI::UCI()
 
 UCI::~UCI()
 {
-    if (search_thread_.joinable())
-    {
-        search_.set_abort(true);
-        search_thread_.join();
-    }
+    cmd_stop();
 }
 
 void UCI::init_handlers()
@@ -40,8 +37,12 @@ void UCI::init_handlers()
     handlers_["position"] = [this](const std::string& args) { cmd_position(args); };
     handlers_["go"] = [this](const std::string& args) { cmd_go(args); };
     handlers_["stop"] = [this](const std::string& /*args*/) { cmd_stop(); };
+    handlers_["ponderhit"] = [this](const std::string& /*args*/) { cmd_ponderhit(); };
     handlers_["setoption"] = [this](const std::string& args) { cmd_setoption(args); };
     handlers_["quit"] = [](const std::string& /*args*/) {};  // handled in run()
+    handlers_["bench"] = [this](const std::string& args) { cmd_bench(args); };
+    handlers_["stats"] = [this](const std::string& /*args*/) { cmd_stats(); };
+    handlers_["treedump"] = [this](const std::string& args) { cmd_treedump(args); };
     handlers_["coach"] = [this](const std::string& args) { coach_dispatcher_.dispatch(args); };
 }
 
@@ -51,11 +52,16 @@ void UCI::cmd_uci()
     std::cout << "id author qam4" << std::endl;
     std::cout << std::endl;
     std::cout << "option name Hash type spin default 16 min 1 max 1024" << std::endl;
+    std::cout << "option name PawnHash type spin default " << PAWN_HASH_DEFAULT_MB
+              << " min 1 max 256" << std::endl;
+    std::cout << "option name Ponder type check default false" << std::endl;
     std::cout << "option name Book type check default " << (book_enabled_ ? "true" : "false")
               << std::endl;
     std::cout << "option name BookFile type string default " << std::endl;
     std::cout << "option name Mobility type check default true" << std::endl;
     std::cout << "option name Tempo type check default true" << std::endl;
+    std::cout << "option name LazyEval type check default true" << std::endl;
+    std::cout << "option name LazyEvalMargin type spin default 400 min 0 max 2000" << std::endl;
     std::cout << "option name MultiPV type spin default 1 min 1 max 256" << std::endl;
     std::cout << "option name Skill type spin default 20 min 1 max 20" << std::endl;
     std::cout << "option name UCI_LimitStrength type check default false" << std::endl;
@@ -71,13 +77,9 @@ void UCI::cmd_isready()
 void UCI::cmd_ucinewgame()
 {
     // Wait for any ongoing search to finish
-    if (search_thread_.joinable())
-    {
-        search_.set_abort(true);
-        search_thread_.join();
-    }
+    cmd_stop();
 
-    board_ = Parser::parse_fen(DEFAULT_FEN);
+    board_.set_position(Parser::parse_fen(DEFAULT_FEN).position());
     board_.get_tt().clear();
     if (nnue_ && nnue_->is_loaded())
     {
@@ -86,25 +88,23 @@ void UCI::cmd_ucinewgame()
     }
     move_nr_ = 0;
     search_.new_game_seed();
+    search_.clear_history();
 }
 
 void UCI::cmd_position(const std::string& args)
 {
     // Wait for any ongoing search to finish before modifying the board
-    if (search_thread_.joinable())
-    {
-        search_.set_abort(true);
-        search_thread_.join();
-    }
+    cmd_stop();
 
     std::istringstream iss(args);
     std::string token;
     iss >> token;
 
-    // Parse position
+    // Parse position. set_position() keeps the board's TT and evaluator, so
+    // the Hash, PawnHash and evaluation options survive a new position.
     if (token == "startpos")
     {
-        board_ = Parser::parse_fen(DEFAULT_FEN);
+        board_.set_position(Parser::parse_fen(DEFAULT_FEN).position());
     }
     else if (token == "fen")
     {
@@ -122,7 +122,7 @@ void UCI::cmd_position(const std::string& args)
             }
             fen += token;
         }
-        board_ = Parser::parse_fen(fen);
+        board_.set_position(Parser::parse_fen(fen).position());
     }
 
     if (nnue_ && nnue_->is_loaded())
@@ -165,11 +165,7 @@ void UCI::cmd_position(const std::string& args)
 void UCI::cmd_go(const std::string& args)
 {
     // Wait for any previous search to finish
-    if (search_thread_.joinable())
-    {
-        search_.set_abort(true);
-        search_thread_.join();
-    }
+    cmd_stop();
 
     // Parse go parameters
     std::istringstream iss(args);
@@ -184,6 +180,7 @@ void UCI::cmd_go(const std::string& args)
     int movetime = -1;
     int nodes = -1;
     bool infinite = false;
+    bool ponder = false;
 
     while (iss >> token)
     {
@@ -223,6 +220,26 @@ void UCI::cmd_go(const std::string& args)
         {
             infinite = true;
         }
+        else if (token == "ponder")
+        {
+            ponder = true;
+        }
+    }
+
+    // Pondering: search the ponder position with no time limit. The clock
+    // is applied on ponderhit; the side to move is the engine's side.
+    {
+        std::lock_guard<std::mutex> lock(ponder_mutex_);
+        ponder_active_ = ponder;
+        ponder_time_ms_ = (board_.side_to_move() == WHITE) ? wtime : btime;
+        ponder_inc_ms_ = (board_.side_to_move() == WHITE) ? winc : binc;
+        ponder_movestogo_ = movestogo;
+    }
+    if (ponder)
+    {
+        wtime = -1;
+        btime = -1;
+        movetime = -1;
     }
 
     start_search(depth, wtime, btime, winc, binc, movestogo, movetime, nodes, infinite);
@@ -230,6 +247,11 @@ void UCI::cmd_go(const std::string& args)
 
 void UCI::cmd_stop()
 {
+    {
+        std::lock_guard<std::mutex> lock(ponder_mutex_);
+        ponder_active_ = false;
+    }
+    ponder_cv_.notify_all();
     search_.set_abort(true);
     if (search_thread_.joinable())
     {
@@ -237,6 +259,40 @@ void UCI::cmd_stop()
     }
 }
 
+void UCI::cmd_ponderhit()
+{
+    int time_ms;
+    int inc_ms;
+    int movestogo;
+    {
+        std::lock_guard<std::mutex> lock(ponder_mutex_);
+        if (!ponder_active_)
+        {
+            return;
+        }
+        ponder_active_ = false;
+        time_ms = ponder_time_ms_;
+        inc_ms = ponder_inc_ms_;
+        movestogo = ponder_movestogo_;
+    }
+    ponder_cv_.notify_all();
+
+    // Keep searching, now against the clock. Without clock info (e.g.
+    // "go ponder infinite") the search simply continues until stop.
+    if (time_ms > 0)
+    {
+        search_.ponderhit(time_ms / 10, inc_ms / 10, movestogo);
+    }
+}
+
+void UCI::wait_for_ponder_end()
+{
+    // The UCI spec forbids sending bestmove while pondering, even when the
+    // search finished early (book move, mate found, depth limit).
+    std::unique_lock<std::mutex> lock(ponder_mutex_);
+    ponder_cv_.wait(lock, [this]() { return !ponder_active_; });
+}
+
 void UCI::cmd_setoption(const std::string& args)
 {
     // Format: "name <name> value <value>"
@@ -284,6 +340,19 @@ void UCI::cmd_setoption(const std::string& args)
         hash_size_mb_ = n;
         board_.get_tt().resize(n);
     }
+    else if (name == "PawnHash")
+    {
+        int n = std::stoi(value);
+        if (n < 1)
+            n = 1;
+        if (n > 256)
+            n = 256;
+        board_.get_hce().resize_pawn_hash(n);
+    }
+    else if (name == "Ponder")
+    {
+        // Nothing to configure: the GUI decides when to send "go ponder"
+    }
     else if (name == "Book")
     {
         if (value == "false")
@@ -319,6 +388,23 @@ void UCI::cmd_setoption(const std::string& args)
         cfg.tempo_enabled = (value == "true");
         board_.get_hce().set_config(cfg);
     }
+    else if (name == "LazyEval")
+    {
+        EvalConfig cfg = board_.get_hce().config();
+        cfg.lazy_enabled = (value == "true");
+        board_.get_hce().set_config(cfg);
+    }
+    else if (name == "LazyEvalMargin")
+    {
+        int n = std::stoi(value);
+        if (n < 0)
+            n = 0;
+        if (n > 2000)
+            n = 2000;
+        EvalConfig cfg = board_.get_hce().config();
+        cfg.lazy_margin = n;
+        board_.get_hce().set_config(cfg);
+    }
     else if (name == "MultiPV")
     {
         int n = std::stoi(value);
@@ -380,6 +466,61 @@ void UCI::cmd_setoption(const std::string& args)
     }
 }
 
+void UCI::cmd_stats()
+{
+    // Non-standard: dump the per-ply tree counters of the last search.
+    // Wait for a running search so the counters are not read mid-update.
+    if (searching_)
+    {
+        std::cout << "info string stats unavailable while searching" << std::endl;
+        return;
+    }
+    search_.get_tree_stats().print(std::cout);
+}
+
+void UCI::cmd_treedump(const std::string& args)
+{
+    // Non-standard: "treedump <file> [nodes]" dumps the tree of each
+    // following search, "treedump off" stops it.
+    if (searching_)
+    {
+        std::cout << "info string treedump unavailable while searching" << std::endl;
+        return;
+    }
+    std::istringstream iss(args);
+    std::string path;
+    U64 max_nodes = TREE_DUMP_DEFAULT_NODES;
+    iss >> path >> max_nodes;
+    if (path == "off")
+    {
+        path.clear();
+    }
+    if (!search_.set_tree_dump(path, max_nodes))
+    {
+        std::cout << "info string treedump not compiled in (configure with "
+                     "-Dblunder_SEARCH_TREE_DUMP=ON)"
+                  << std::endl;
+    }
+    else if (!path.empty())
+    {
+        std::cout << "info string treedump " << path << " nodes " << max_nodes << std::endl;
+    }
+}
+
+void UCI::cmd_bench(const std::string& args)
+{
+    // Non-standard: "bench [depth] [hash] [threads] [hce|nnue] [--json]"
+    cmd_stop();
+    std::vector<std::string> bench_args;
+    std::istringstream iss(args);
+    std::string token;
+    while (iss >> token)
+    {
+        bench_args.push_back(token);
+    }
+    bench_command(bench_args, nnue_, std::cout);
+}
+
 void UCI::start_search(int depth,
                        int wtime,
                        int btime,
@@ -393,8 +534,43 @@ void UCI::start_search(int depth,
     searching_ = true;
     search_.set_abort(false);
 
+    // Set up the alpha-beta time manager here, before the search thread
+    // exists: a ponderhit handled right after this call then updates the
+    // limits instead of being overwritten by them.
+    {
+        auto lock = search_.lock_tm();
+        TimeManager& tm = search_.get_tm();
+        if (nodes != -1)
+        {
+            tm.start(-1, nodes);  // the node budget overrides the clock
+        }
+        else if (infinite)
+        {
+            tm.start(-1, -1);  // no time limit
+        }
+        else if (movetime > 0)
+        {
+            // movetime in ms → microseconds
+            tm.start(movetime * 1000);
+        }
+        else
+        {
+            // Clock-based time management
+            int time_ms = (board_.side_to_move() == WHITE) ? wtime : btime;
+            int inc_ms = (board_.side_to_move() == WHITE) ? winc : binc;
+            if (time_ms > 0)
+            {
+                tm.allocate(time_ms / 10, inc_ms / 10, movestogo);
+            }
+            else
+            {
+                tm.start(-1, -1);
+            }
+        }
+    }
+
     search_thread_ = std::thread(
-        [this, depth, wtime, btime, winc, binc, movestogo, movetime, nodes, infinite]()
+        [this, depth, wtime, btime, winc, binc, movestogo, movetime, infinite]()
         {
             Move_t best_move = 0;
             Move_t ponder_move = 0;
@@ -413,6 +589,7 @@ void UCI::start_search(int depth,
                 Move_t book_move = book_.get_move(board_);
                 if (book_move != Move(0))
                 {
+                    wait_for_ponder_end();
                     send_bestmove(book_move, 0);
                     searching_ = false;
                     return;
@@ -459,39 +636,16 @@ void UCI::start_search(int depth,
                     best_move = mcts.search(&mcts_tm);
                 }
 
+                wait_for_ponder_end();
                 send_bestmove(best_move, 0);
                 searching_ = false;
                 return;
             }
 
-            // Alpha-beta search path
-            if (infinite)
-            {
-                search_.get_tm().start(-1, -1);  // no time limit
-            }
-            else if (movetime > 0)
-            {
-                // movetime in ms → microseconds
-                search_.get_tm().start(movetime * 1000);
-            }
-            else
-            {
-                // Clock-based time management
-                int time_ms = (board_.side_to_move() == WHITE) ? wtime : btime;
-                int inc_ms = (board_.side_to_move() == WHITE) ? winc : binc;
-                if (time_ms > 0)
-                {
-                    search_.get_tm().allocate(time_ms / 10, inc_ms / 10, movestogo);
-                }
-                else
-                {
-                    search_.get_tm().start(-1, nodes);
-                }
-            }
-
+            // Alpha-beta search path (time manager set up by the caller)
             search_.set_verbose(true);
             search_.set_output_mode(Search::OutputMode::UCI);
-            best_move = search_.search(depth, -1, nodes, false, multipv_count_);
+            best_move = search_.search(depth, -1, -1, false, multipv_count_);
 
             // Extract bestmove and ponder from top PV line
             const auto& results = search_.get_multipv_results();
@@ -501,6 +655,7 @@ void UCI::start_search(int depth,
                 ponder_move = results[0].ponder_move();
             }
 
+            wait_for_ponder_end();
             send_bestmove(best_move, ponder_move);
             searching_ = false;
         });
@@ -9,7 +9,9 @@
 #define UCI_H
 
 #include <atomic>
+#include <condition_variable>
 #include <functional>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <unordered_map>
@@ -77,11 +79,16 @@ private:
     void cmd_position(const std::string& args);
     void cmd_go(const std::string& args);
     void cmd_stop();
+    void cmd_ponderhit();
     void cmd_setoption(const std::string& args);
+    void cmd_stats();
+    void cmd_treedump(const std::string& args);
+    void cmd_bench(const std::string& args);
 
     // Search helpers
     void start_search(int depth, int wtime, int btime, int winc, int binc,
                       int movestogo, int movetime, int nodes, bool infinite);
+    void wait_for_ponder_end();
     void send_bestmove(Move_t move, Move_t ponder_move);
     void send_info(int depth, int score_cp, int nodes, int nps,
                    int time_ms, const std::string& pv);
@@ -107,6 +114,15 @@ private:
     std::thread search_thread_;
     std::atomic<bool> searching_{false};
 
+    // Pondering ("go ponder"): the search runs without a time limit until
+    // ponderhit/stop. The clock from the go command is kept for ponderhit.
+    std::mutex ponder_mutex_;
+    std::condition_variable ponder_cv_;
+    bool ponder_active_ = false;
+    int ponder_time_ms_ = -1;
+    int ponder_inc_ms_ = 0;
+    int ponder_movestogo_ = 0;
+
     // Game state
     int move_nr_ = 0;
 
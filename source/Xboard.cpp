@@ -136,6 +136,7 @@ int Xboard::search_best_move(int stm,
     int inc_cs = static_cast<int>(inc * 100);
     search_.get_tm().allocate(time_left, inc_cs, mps);
 
+    search_.set_abort(false);
     Move_t best_move = search_.search(max_depth, -1, -1, true);
     *move = best_move;
 
@@ -166,8 +167,8 @@ void Xboard::ponder_until_input(int stm)
     // call).  Save and restore so undo_move finds the right stack slot.
     int saved_search_ply = board_.get_search_ply();
 
-    // Use a very deep depth limit; the search will stop when input_available()
-    // triggers the abort flag inside the periodic node check.
+    // Use a very deep depth limit; the search timer thread raises the abort
+    // flag as soon as input_available() reports a pending command.
     search_.get_tm().start(-1, -1);  // no time limit, no node limit
     search_.search(MAX_SEARCH_PLY, -1, -1, false);
 
@@ -303,6 +304,7 @@ void Xboard::init_handlers()
         randomize_ = OFF;
         move_nr_ = 0;
         search_.new_game_seed();
+        search_.clear_history();
     };
 
     handlers_["setboard"] = [this](const std::string& args, RunState& rs)
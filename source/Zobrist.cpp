@@ -4,25 +4,35 @@
  */
 
 #include <random>
+#include <utility>
 
 #include "Zobrist.h"
 
 #include "Board.h"
+#include "LookupTables.h"
+#include "MoveGenerator.h"
 
 // Static member definitions
 U64 Zobrist::pieces_[NUM_PIECES][NUM_SQUARES] = {};
 U64 Zobrist::castling_rights_[FULL_CASTLING_RIGHTS + 1] = {};
 U64 Zobrist::ep_square_[NUM_SQUARES] = {};
 U64 Zobrist::side_ = 0;
-bool Zobrist::initialized_ = false;
+U64 Zobrist::cuckoo_keys_[CUCKOO_SIZE] = {};
+U8 Zobrist::cuckoo_squares_[CUCKOO_SIZE][2] = {};
 
 void Zobrist::init()
 {
-    if (initialized_)
-    {
-        return;
-    }
+    // Runs fill_keys() exactly once, even if several threads get here at the
+    // same time (function-local static); later calls only test a flag.
+    static const bool initialized = (fill_keys(), true);
+    (void)initialized;
+}
 
+// Keys are ready before main(); see MoveGeneratorMagicBitboards.cpp
+static const bool zobrist_ready = (Zobrist::init(), true);
+
+void Zobrist::fill_keys()
+{
     std::mt19937_64 gen(0);
     std::uniform_int_distribution<uint64_t> dist(0, UINT64_MAX);
 
@@ -45,7 +55,65 @@ void Zobrist::init()
     }
     side_ = dist(gen);
 
-    initialized_ = true;
+    fill_cuckoo();
+}
+
+// Marcel van Kervinck's cuckoo tables, as in Stockfish: each key has two
+// candidate slots; inserting into an occupied slot moves the old entry to
+// its other slot.
+void Zobrist::fill_cuckoo()
+{
+    int count = 0;
+    for (U8 piece = WHITE_KNIGHT; piece <= BLACK_KING; piece++)
+    {
+        for (U8 sq1 = 0; sq1 < NUM_SQUARES; sq1++)
+        {
+            U64 targets;
+            switch (piece & ~1)
+            {
+                case KNIGHT:
+                    targets = KNIGHT_LOOKUP_TABLE[sq1];
+                    break;
+                case BISHOP:
+                    targets = MoveGenerator::bishop_attacks_slow(0ULL, sq1);
+                    break;
+                case ROOK:
+                    targets = MoveGenerator::rook_attacks_slow(0ULL, sq1);
+                    break;
+                case QUEEN:
+                    targets = MoveGenerator::bishop_attacks_slow(0ULL, sq1)
+                        | MoveGenerator::rook_attacks_slow(0ULL, sq1);
+                    break;
+                default:
+                    targets = KING_LOOKUP_TABLE[sq1];
+                    break;
+            }
+            for (U8 sq2 = static_cast<U8>(sq1 + 1); sq2 < NUM_SQUARES; sq2++)
+            {
+                if (!(targets & (1ULL << sq2)))
+                {
+                    continue;
+                }
+                U64 key = pieces_[piece][sq1] ^ pieces_[piece][sq2] ^ side_;
+                U8 squares[2] = { sq1, sq2 };
+                U32 i = cuckoo_h1(key);
+                for (;;)
+                {
+                    std::swap(cuckoo_keys_[i], key);
+                    std::swap(cuckoo_squares_[i][0], squares[0]);
+                    std::swap(cuckoo_squares_[i][1], squares[1]);
+                    if (key == 0)
+                    {
+                        break;  // empty slot
+                    }
+                    i = (i == cuckoo_h1(key)) ? cuckoo_h2(key) : cuckoo_h1(key);
+                }
+                count++;
+            }
+        }
+    }
+    assert(count == 3668);
+    (void)count;
 }
 
 U64 Zobrist::get_zobrist_key(const Board& board)
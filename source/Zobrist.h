@@ -16,7 +16,8 @@ class Board;
 class Zobrist
 {
 public:
-    /// Initialize static key tables. Must be called once before any Board use.
+    /// Initialize static key tables. Runs during static initialization;
+    /// calling it again is cheap and thread-safe.
     static void init();
 
     static U64 get_zobrist_key(const Board& board);
@@ -25,12 +26,41 @@ public:
     static U64 get_ep_square(U8 square) { return ep_square_[square]; }
     static U64 get_side() { return side_; }
 
+    /// Cuckoo table of reversible moves: for a key that is the difference of
+    /// two positions one non-pawn, non-capture move apart, find the move's
+    /// squares (in either order). Returns false for any other key.
+    static bool find_cuckoo_move(U64 move_key, U8& sq1, U8& sq2)
+    {
+        U32 i = cuckoo_h1(move_key);
+        if (cuckoo_keys_[i] != move_key)
+        {
+            i = cuckoo_h2(move_key);
+            if (cuckoo_keys_[i] != move_key)
+            {
+                return false;
+            }
+        }
+        sq1 = cuckoo_squares_[i][0];
+        sq2 = cuckoo_squares_[i][1];
+        return true;
+    }
+
 private:
     static U64 pieces_[NUM_PIECES][NUM_SQUARES];
     static U64 castling_rights_[FULL_CASTLING_RIGHTS + 1];
     static U64 ep_square_[NUM_SQUARES];
     static U64 side_;
-    static bool initialized_;
+
+    // 3668 moves: every piece of either colour between every pair of
+    // squares it can move between on an empty board
+    static constexpr int CUCKOO_SIZE = 8192;
+    static U64 cuckoo_keys_[CUCKOO_SIZE];
+    static U8 cuckoo_squares_[CUCKOO_SIZE][2];
+    static U32 cuckoo_h1(U64 key) { return static_cast<U32>(key) & (CUCKOO_SIZE - 1); }
+    static U32 cuckoo_h2(U64 key) { return static_cast<U32>(key >> 16) & (CUCKOO_SIZE - 1); }
+
+    static void fill_keys();
+    static void fill_cuckoo();
 };
 
 #endif /* ZOBRIST_H */
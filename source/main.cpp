@@ -3,6 +3,8 @@
  *
  */
 
+#include <algorithm>
+#include <cctype>
 #include <cstdlib>
 #include <ctime>
 #include <iostream>
@@ -13,6 +15,7 @@
 #    include <windows.h>
 #endif
 
+#include "Bench.h"
 #include "Board.h"
 #include "Book.h"
 #include "CLIConfig.h"
@@ -128,10 +131,46 @@ int main(int argc, char** argv)
         return 0;
     }
 
-    if (cmd_line_args.cmd_option_exists("--perft"))
+    if (cmd_line_args.cmd_option_exists("--perft")
+        || cmd_line_args.cmd_option_exists("--perft-suite"))
     {
+        int threads = 1;
+        int hash_mb = 0;
+        if (cmd_line_args.cmd_option_exists("--threads"))
+        {
+            threads = std::max(1, str2int(cmd_line_args.get_cmd_option("--threads")));
+        }
+        if (cmd_line_args.cmd_option_exists("--perft-hash"))
+        {
+            hash_mb = str2int(cmd_line_args.get_cmd_option("--perft-hash"));
+        }
+
+        if (cmd_line_args.cmd_option_exists("--perft-suite"))
+        {
+            int depth = 5;
+            if (cmd_line_args.cmd_option_exists("--perft-depth"))
+            {
+                depth = str2int(cmd_line_args.get_cmd_option("--perft-depth"));
+            }
+            cout << "Perft suite..." << endl;
+            int failures = perft_suite(
+                cmd_line_args.get_cmd_option("--perft-suite"), depth, threads, hash_mb);
+            return failures == 0 ? 0 : 1;
+        }
+
+        int depth = 6;
+        string depth_arg = cmd_line_args.get_cmd_option("--perft");
+        if (!depth_arg.empty() && isdigit(static_cast<unsigned char>(depth_arg[0])))
+        {
+            depth = str2int(depth_arg);
+        }
+        string fen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+        if (cmd_line_args.cmd_option_exists("--fen"))
+        {
+            fen = cmd_line_args.get_cmd_option("--fen");
+        }
         cout << "Perft..." << endl;
-        perft_benchmark("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 6);
+        perft_benchmark(fen, depth, threads, hash_mb, cmd_line_args.cmd_option_exists("--divide"));
         return 0;
     }
 
@@ -145,6 +184,53 @@ int main(int argc, char** argv)
     NNUEEvaluator nnue;
     bool nnue_loaded = load_nnue(nnue, cfg);
 
+    // Consistency check of incremental state along a perft tree
+    if (cmd_line_args.cmd_option_exists("--perft-verify"))
+    {
+        int depth = 4;
+        string depth_arg = cmd_line_args.get_cmd_option("--perft-verify");
+        if (!depth_arg.empty() && isdigit(static_cast<unsigned char>(depth_arg[0])))
+        {
+            depth = str2int(depth_arg);
+        }
+        string fen;
+        if (cmd_line_args.cmd_option_exists("--fen"))
+        {
+            fen = cmd_line_args.get_cmd_option("--fen");
+        }
+        cout << "Perft verify..." << endl;
+        int failures = perft_verify_command(fen, depth, nnue_loaded ? &nnue : nullptr);
+        return failures == 0 ? 0 : 1;
+    }
+
+    // blunder bench [depth] [hash] [threads] [evaltype] [--json]
+    if (argc > 1 && string(argv[1]) == "bench")
+    {
+        vector<string> bench_args;
+        for (int i = 2; i < argc && argv[i][0] != '-'; i++)
+        {
+            bench_args.push_back(argv[i]);
+        }
+        if (cmd_line_args.cmd_option_exists("--json"))
+        {
+            bench_args.push_back("--json");
+        }
+        bench_command(bench_args, nnue_loaded ? &nnue : nullptr, cout);
+        return 0;
+    }
+
+    // blunder speedtest [depth] [rounds] [hash] [evaltype]
+    if (argc > 1 && string(argv[1]) == "speedtest")
+    {
+        vector<string> speedtest_args;
+        for (int i = 2; i < argc && argv[i][0] != '-'; i++)
+        {
+            speedtest_args.push_back(argv[i]);
+        }
+        speedtest_command(speedtest_args, nnue_loaded ? &nnue : nullptr, cout);
+        return 0;
+    }
+
     if (cmd_line_args.cmd_option_exists("--xboard"))
     {
         Xboard xboard;
@@ -185,7 +271,43 @@ int main(int argc, char** argv)
             cout << "Error: path to EPD file required " << endl;
             return 1;
         }
-        test_positions_benchmark(epd_path);
+        bool limited = cmd_line_args.cmd_option_exists("--depth")
+            || cmd_line_args.cmd_option_exists("--movetime")
+            || cmd_line_args.cmd_option_exists("--nodes");
+        bool json = cmd_line_args.cmd_option_exists("--json");
+        if (!limited && !json && !cmd_line_args.cmd_option_exists("--jobs"))
+        {
+            test_positions_benchmark(epd_path);
+            return 0;
+        }
+
+        SearchMode mode = SearchMode::FixedNodes;
+        int param = TEST_POSITIONS_MAX_NODES_VISITED;
+        if (cmd_line_args.cmd_option_exists("--depth"))
+        {
+            mode = SearchMode::FixedDepth;
+            param = std::clamp(
+                str2int(cmd_line_args.get_cmd_option("--depth")), 1, MAX_SEARCH_PLY - 1);
+        }
+        else if (cmd_line_args.cmd_option_exists("--movetime"))
+        {
+            mode = SearchMode::FixedTime;
+            param = std::max(1, str2int(cmd_line_args.get_cmd_option("--movetime")));
+        }
+        else if (cmd_line_args.cmd_option_exists("--nodes"))
+        {
+            param = std::max(1, str2int(cmd_line_args.get_cmd_option("--nodes")));
+        }
+        int jobs = 1;
+        if (cmd_line_args.cmd_option_exists("--jobs"))
+        {
+            jobs = std::max(1, str2int(cmd_line_args.get_cmd_option("--jobs")));
+        }
+        BenchmarkResult result = test_positions_ex(epd_path, mode, param, jobs, json);
+        if (json)
+        {
+            cout << test_positions_json(result) << endl;
+        }
         return 0;
     }
 
@@ -285,6 +407,7 @@ int main(int argc, char** argv)
 
             clock_t tic = clock();
             cout << "Thinking..." << endl;
+            search.set_abort(false);
             Move_t move = search.search(MAX_SEARCH_PLY);
             clock_t toc = clock();
             double elapsed_secs = double(toc - tic) / CLOCKS_PER_SEC;
@@ -401,14 +524,29 @@ void print_help()
 void usage(const string& prog_name)
 {
     cout << prog_name
-         << "\n"
+         << " [bench [depth] [hash] [threads] [hce|nnue] [--json]]\n"
+         << "       " << prog_name << " [speedtest [depth] [rounds] [hash] [hce|nnue]]\n"
             "Options:\n"
             "-h|--help                        Print this help\n"
             "--gen-lookup-tables              Generate lookup tables\n"
-            "--perft                          Run perft benchmark\n"
+            "--perft [depth]                  Run perft benchmark (default: depth 6)\n"
+            "  --fen <fen>                    Position to run perft on (default: start)\n"
+            "  --divide                       Print the count below each root move\n"
+            "  --threads <N>                  Split root moves across N threads\n"
+            "  --perft-hash <MB>              Per-thread perft hash table size\n"
+            "--perft-suite <epd>              Check the counts of an EPD perft suite\n"
+            "  --perft-depth <D>              Deepest count to check (default: 5)\n"
+            "--perft-verify [depth]           Check incremental hash, NNUE and eval state\n"
+            "                                 along a perft tree (default: depth 4; --fen,\n"
+            "                                 --nnue <path> to include the accumulator)\n"
             "--xboard                         xboard interface\n"
             "--uci                            UCI interface\n"
             "--test-positions path-to-epd     Run test positions\n"
+            "  --jobs <N>                     Search N positions concurrently\n"
+            "  --depth <D>                    Fixed depth per position\n"
+            "  --movetime <ms>                Fixed time per position\n"
+            "  --nodes <N>                    Node limit per position (default: 1000000)\n"
+            "  --json                         Print per-position records and a summary as JSON\n"
             "--book <path>                    Use opening book at <path>\n"
             "--no-book                        Disable opening book\n"
             "--book-depth <N>                 Stop using book after N plies\n"
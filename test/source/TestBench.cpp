@@ -0,0 +1,80 @@
+/*
+ * File:   TestBench.cpp
+ *
+ */
+
+#include <sstream>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "Bench.h"
+#include "Tests.h"
+#include "Trace.h"
+
+TEST_CASE("bench_positions_are_legal", "[bench]")
+{
+    REQUIRE(NUM_BENCH_FENS >= 50);
+    for (int i = 0; i < NUM_BENCH_FENS; i++)
+    {
+        INFO("FEN: " << BENCH_FENS[i]);
+        Board board = Parser::parse_fen(BENCH_FENS[i]);
+        // The side that just moved must not be left in check
+        REQUIRE_FALSE(MoveGenerator::in_check(board, board.side_to_move() ^ 1));
+    }
+}
+
+TEST_CASE("bench_signature_does_not_depend_on_threads", "[bench]")
+{
+    std::ostringstream out;
+    BenchConfig config;
+    config.depth = 3;
+    config.hash_mb = 1;
+
+    BenchResult single = bench(config, out);
+    config.threads = 3;
+    BenchResult multi = bench(config, out);
+
+    REQUIRE(single.nodes > 0);
+    REQUIRE(multi.nodes == single.nodes);
+    REQUIRE(multi.position_nodes == single.position_nodes);
+}
+
+TEST_CASE("bench_command_parses_arguments", "[bench]")
+{
+    std::ostringstream out;
+    BenchResult result = bench_command({ "2", "1", "1", "hce" }, nullptr, out);
+    REQUIRE(result.position_nodes.size() == static_cast<size_t>(NUM_BENCH_FENS));
+    REQUIRE(out.str().find("Depth           : 2") != std::string::npos);
+    REQUIRE(out.str().find("Nodes searched  : " + std::to_string(result.nodes))
+            != std::string::npos);
+}
+
+TEST_CASE("speedtest_rounds_search_the_same_tree", "[bench]")
+{
+    std::ostringstream out;
+    std::vector<BenchResult> samples = speedtest_command({ "2", "3", "1" }, nullptr, out);
+    REQUIRE(samples.size() == 3);
+    REQUIRE(samples[0].nodes > 0);
+    REQUIRE(samples[1].nodes == samples[0].nodes);
+    REQUIRE(samples[2].nodes == samples[0].nodes);
+    REQUIRE(out.str().find("sample 3 nodes " + std::to_string(samples[0].nodes) + " time ")
+            != std::string::npos);
+}
+
+TEST_CASE("bench_reports_hot_path_trace_when_compiled_in", "[bench]")
+{
+    std::ostringstream out;
+    BenchConfig config;
+    config.depth = 2;
+    config.hash_mb = 1;
+    bench(config, out);
+    // The trace table is only printed by -Dblunder_TRACE=ON builds
+    REQUIRE((out.str().find("add_all_moves") != std::string::npos) == TRACING);
+
+    std::ostringstream trace;
+    Trace::print(trace);
+    if (!TRACING)
+    {
+        REQUIRE(trace.str().find("not compiled in") != std::string::npos);
+    }
+}
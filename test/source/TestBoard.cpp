@@ -5,6 +5,7 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include "Output.h"
 #include "Tests.h"
 
 TEST_CASE("board_can_construct", "[board]")
@@ -50,3 +51,52 @@ TEST_CASE("board_is_game_over", "[board]")
 {
     // TODO
 }
+
+TEST_CASE("board_set_position_starts_from_a_copied_position", "[board]")
+{
+    cout << "- Can set a copied position" << endl;
+    Board board =
+        Parser::parse_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    Position pos = board.position();
+
+    Board other = Board();
+    other.set_position(pos);
+    REQUIRE(Output::board_to_fen(other) == Output::board_to_fen(board));
+    REQUIRE(other.get_hash() == board.get_hash());
+    REQUIRE(other.get_game_ply() == 0);
+
+    // The copy is independent of the board it was taken from
+    board.do_move(build_capture(E2, A6, BLACK_BISHOP));
+    REQUIRE(other.position().state.hash == pos.state.hash);
+    REQUIRE(other[A6] == BLACK_BISHOP);
+}
+
+TEST_CASE("board_copies_keep_their_own_epd_ops", "[board]")
+{
+    cout << "- Board copies keep their own EPD ops" << endl;
+    Board board = Parser::parse_epd("8/8/8/8/8/8/8/K6k w - - bm Kb1; id \"test\";");
+    Board copy = board;
+    copy.set_epd_op("id", "copy");
+    REQUIRE(board.epd_op("id") == "\"test\"");
+    REQUIRE(copy.epd_op("id") == "copy");
+    REQUIRE(copy.epd_op("bm") == "Kb1");
+    REQUIRE(board.epd_op("c0").empty());
+}
+
+TEST_CASE("board_copies_keep_their_own_evaluator", "[board]")
+{
+    cout << "- Board copies keep their own evaluator" << endl;
+    Board board = Parser::parse_fen(DEFAULT_FEN);
+    int score = board.get_hce().evaluate(board, -10000, 10000);
+
+    Board copy = board;
+    EvalConfig cfg = copy.get_hce().config();
+    cfg.mobility_enabled = false;
+    copy.get_hce().set_config(cfg);
+    copy.get_hce().evaluate(copy, -10000, 10000);
+
+    REQUIRE(board.get_hce().config().mobility_enabled);
+    REQUIRE(board.get_hce().lazy_stats().calls == 1);
+    REQUIRE(copy.get_hce().lazy_stats().calls == 1);
+    REQUIRE(board.get_hce().evaluate(board) == score);
+}
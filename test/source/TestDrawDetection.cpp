@@ -86,6 +86,44 @@ TEST_CASE("twofold_repetition_in_search", "[draw detection]")
     REQUIRE(board.is_draw(true));
 }
 
+// ---------------------------------------------------------------------------
+// Upcoming repetition: a reversible move reaches a position of the game
+// ---------------------------------------------------------------------------
+
+TEST_CASE("game_cycle_after_knight_shuffle", "[draw detection]")
+{
+    Board board = Parser::parse_fen(DEFAULT_FEN);
+    board.do_move(build_move(G1, F3));
+    board.do_move(build_move(G8, F6));
+    REQUIRE_FALSE(board.has_game_cycle());
+    board.do_move(build_move(F3, G1));
+    // Black can play Ng8 back into the start position
+    REQUIRE(board.has_game_cycle());
+    board.do_move(build_move(F6, G8));
+    REQUIRE(board.is_draw(true));
+}
+
+TEST_CASE("game_cycle_needs_a_clear_path", "[draw detection]")
+{
+    // The rook walks a1-b1-b7-a7 while the black king goes h8-g8-f8-g8-h8.
+    // Ra1 would repeat the first position, unless the a4 pawn is in the way.
+    // Kg8 would repeat a position too, but it is not white's move.
+    const char* fens[] = { "7k/8/8/8/8/8/8/R3K3 b - - 0 1", "7k/8/8/8/P7/8/8/R3K3 b - - 0 1" };
+    const Move_t moves[] = { build_move(H8, G8), build_move(A1, B1), build_move(G8, F8),
+                             build_move(B1, B7), build_move(F8, G8), build_move(B7, A7),
+                             build_move(G8, H8) };
+    for (const char* fen : fens)
+    {
+        Board board = Parser::parse_fen(fen);
+        for (Move_t move : moves)
+        {
+            board.do_move(move);
+        }
+        bool blocked = board[A4] != EMPTY;
+        REQUIRE(board.has_game_cycle() == !blocked);
+    }
+}
+
 // ---------------------------------------------------------------------------
 // Mate detection: checkmate returns mate score
 // ---------------------------------------------------------------------------
@@ -102,3 +102,126 @@ TEST_CASE("evaluation_color_symmetry", "[evaluation]")
         REQUIRE(orig_score == -mirror_score);
     }
 }
+
+TEST_CASE("attack_info_matches_attacks_from_scratch", "[evaluation]")
+{
+    for (int i = 0; i < NUM_SYMMETRY_FENS; i++)
+    {
+        Board board = Parser::parse_fen(SYMMETRY_FENS[i]);
+        AttackInfo info;
+        info.compute(board);
+        INFO("FEN: " << SYMMETRY_FENS[i]);
+
+        U64 occupied = board.bitboard(WHITE) | board.bitboard(BLACK);
+        REQUIRE(info.occupied == occupied);
+        for (U8 side = WHITE; side <= BLACK; side++)
+        {
+            U64 king_bb = board.bitboard(KING | side);
+            U64 zone = king_bb | MoveGenerator::king_targets(king_bb);
+            REQUIRE(info.king_zone[side] == zone);
+
+            // Enemy knights, bishops, rooks and queens hitting the zone, one
+            // piece at a time
+            int attackers = 0;
+            for (int sq = 0; sq < NUM_SQUARES; sq++)
+            {
+                U8 piece = board[sq];
+                if (piece == EMPTY || (piece & 1) == side)
+                {
+                    continue;
+                }
+                U64 attacks = 0;
+                switch (piece & ~1)
+                {
+                    case KNIGHT:
+                        attacks = MoveGenerator::knight_targets(1ULL << sq);
+                        break;
+                    case BISHOP:
+                        attacks = MoveGenerator::bishop_attacks(occupied, sq);
+                        break;
+                    case ROOK:
+                        attacks = MoveGenerator::rook_attacks(occupied, sq);
+                        break;
+                    case QUEEN:
+                        attacks = MoveGenerator::rook_attacks(occupied, sq)
+                            | MoveGenerator::bishop_attacks(occupied, sq);
+                        break;
+                    default:
+                        break;
+                }
+                attackers += (attacks & zone) != 0;
+            }
+            REQUIRE(info.king_zone_attackers[side] == attackers);
+        }
+    }
+}
+
+TEST_CASE("lazy_eval_keeps_the_side_of_the_window", "[evaluation]")
+{
+    const int offsets[] = { -1000, -450, -100, 0, 100, 450, 1000 };
+    for (int i = 0; i < NUM_SYMMETRY_FENS; i++)
+    {
+        Board board = Parser::parse_fen(SYMMETRY_FENS[i]);
+        HandCraftedEvaluator& hce = board.get_hce();
+        EvalConfig cfg = hce.config();
+        cfg.lazy_verify = true;
+        hce.set_config(cfg);
+        int full = hce.side_relative_eval(board);
+        INFO("FEN: " << SYMMETRY_FENS[i]);
+
+        for (int offset : offsets)
+        {
+            int alpha = full + offset - 1;
+            int beta = full + offset + 1;
+            int score = hce.side_relative_eval(board, alpha, beta);
+            if (alpha < full && full < beta)
+            {
+                REQUIRE(score == full);
+            }
+            REQUIRE((score <= alpha) == (full <= alpha));
+            REQUIRE((score >= beta) == (full >= beta));
+        }
+        REQUIRE(hce.lazy_stats().exits > 0);
+        REQUIRE(hce.lazy_stats().errors == 0);
+    }
+}
+
+TEST_CASE("pawn_hash_entry_matches_recomputation", "[evaluation]")
+{
+    // Passed pawns by file and rank, from the front spans
+    Board passers = Parser::parse_fen("4k3/8/6p1/3P4/1p5P/4p3/P7/4K3 w - - 0 1");
+    const PawnHashEntry& entry = passers.get_hce().probe_pawns(passers);
+    REQUIRE(entry.passed[WHITE] == (1ULL << D5));
+    REQUIRE(entry.passed[BLACK] == (1ULL << E3));
+    REQUIRE(entry.isolated_files[WHITE] == ((1 << 0) | (1 << 3) | (1 << 7)));
+
+    for (int i = 0; i < NUM_SYMMETRY_FENS; i++)
+    {
+        Board board = Parser::parse_fen(SYMMETRY_FENS[i]);
+        HandCraftedEvaluator& hce = board.get_hce();
+        hce.resize_pawn_hash(1);
+        REQUIRE(hce.pawn_hash_entries() == 1024 * 1024 / sizeof(PawnHashEntry));
+        INFO("FEN: " << SYMMETRY_FENS[i]);
+
+        // A hit, with the shelter cached by the first evaluation, must
+        // agree with a fresh computation
+        int cached = hce.evaluate(board);
+        REQUIRE(hce.evaluate(board) == cached);
+        PawnHashEntry hit = hce.probe_pawns(board);
+        EvalConfig cfg = hce.config();
+        cfg.pawn_hash_enabled = false;
+        hce.set_config(cfg);
+        REQUIRE(hce.evaluate(board) == cached);
+        const PawnHashEntry& fresh = hce.probe_pawns(board);
+        REQUIRE(hit.key == fresh.key);
+        REQUIRE(hit.mg_score == fresh.mg_score);
+        REQUIRE(hit.eg_score == fresh.eg_score);
+        for (U8 side = WHITE; side <= BLACK; side++)
+        {
+            REQUIRE(hit.passed[side] == fresh.passed[side]);
+            REQUIRE(hit.attack_span[side] == fresh.attack_span[side]);
+            REQUIRE(hit.isolated_files[side] == fresh.isolated_files[side]);
+            REQUIRE(hit.doubled_files[side] == fresh.doubled_files[side]);
+        }
+    }
+}
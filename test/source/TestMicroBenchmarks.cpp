@@ -0,0 +1,456 @@
+/*
+ * File:   TestMicroBenchmarks.cpp
+ *
+ * Microbenchmarks of the engine's hot primitives over the bench position
+ * corpus: move generation (legal vs pseudo-legal), make/unmake, SEE,
+ * in_check, hand-crafted and NNUE evaluation, and the Magic vs PEXT vs
+ * Hyperbola slider attack backends.
+ *
+ * Each BENCHMARK runs its operation once over the whole corpus; the op count
+ * is in the benchmark name, so ns/op = mean / ops. The cases are hidden
+ * ([.]) to keep them out of the default run:
+ *
+ *     blunder_test "[microbench]" --benchmark-samples 50
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "Bench.h"
+#include "Board.h"
+#include "MoveGenerator.h"
+#include "MoveList.h"
+#include "NNUEEvaluator.h"
+#include "Parser.h"
+
+static std::vector<Board> corpus_boards()
+{
+    std::vector<Board> boards;
+    boards.reserve(static_cast<size_t>(NUM_BENCH_FENS));
+    for (int i = 0; i < NUM_BENCH_FENS; i++)
+    {
+        // No search runs here: shrink the tables so the corpus stays small
+        Board board = Parser::parse_fen(BENCH_FENS[i]);
+        board.get_tt().resize(1);
+        board.get_hce().resize_pawn_hash(1);
+        boards.push_back(board);
+    }
+    return boards;
+}
+
+static std::string ops(const char* name, size_t count)
+{
+    return std::string(name) + " (" + std::to_string(count) + " ops)";
+}
+
+static void add_pseudo_legal_moves(PseudoMoveList& list, const Board& board, U8 side)
+{
+    MoveGenerator::add_pawn_pushes(list, board, side);
+    MoveGenerator::add_pawn_attacks(list, board, side);
+    MoveGenerator::add_knight_moves(list, board, side);
+    MoveGenerator::add_bishop_moves(list, board, side);
+    MoveGenerator::add_rook_moves(list, board, side);
+    MoveGenerator::add_queen_moves(list, board, side);
+    MoveGenerator::add_king_moves(list, board, side);
+}
+
+TEST_CASE("microbench move generation", "[.][microbench]")
+{
+    std::vector<Board> boards = corpus_boards();
+
+    size_t legal = 0;
+    size_t pseudo = 0;
+    for (const Board& board : boards)
+    {
+        MoveList legal_list;
+        MoveGenerator::add_all_moves(legal_list, board, board.side_to_move());
+        PseudoMoveList pseudo_list;
+        add_pseudo_legal_moves(pseudo_list, board, board.side_to_move());
+        legal += static_cast<size_t>(legal_list.length());
+        pseudo += static_cast<size_t>(pseudo_list.length());
+    }
+    REQUIRE(legal > 0);
+    REQUIRE(pseudo > 0);
+
+    std::string legal_name = ops("add_all_moves, per position", boards.size()) + ", "
+        + std::to_string(legal) + " moves";
+    BENCHMARK(legal_name)
+    {
+        int n = 0;
+        for (const Board& board : boards)
+        {
+            MoveList list;
+            MoveGenerator::add_all_moves(list, board, board.side_to_move());
+            n += list.length();
+        }
+        return n;
+    };
+
+    std::string pseudo_name = ops("pseudo-legal generators, per position", boards.size()) + ", "
+        + std::to_string(pseudo) + " moves";
+    BENCHMARK(pseudo_name)
+    {
+        int n = 0;
+        for (const Board& board : boards)
+        {
+            PseudoMoveList list;
+            add_pseudo_legal_moves(list, board, board.side_to_move());
+            n += list.length();
+        }
+        return n;
+    };
+
+    BENCHMARK(ops("add_all_moves + score_moves + pick all, per position", boards.size()))
+    {
+        int n = 0;
+        for (const Board& board : boards)
+        {
+            MoveList list;
+            MoveGenerator::add_all_moves(list, board, board.side_to_move());
+            MoveGenerator::score_moves(list, board);
+            for (int i = 0; i < list.length(); i++)
+            {
+                list.sort_moves(i);
+                n += static_cast<int>(list[i] & 1);
+            }
+        }
+        return n;
+    };
+
+    BENCHMARK(ops("add_loud_moves, per position", boards.size()))
+    {
+        int n = 0;
+        for (const Board& board : boards)
+        {
+            MoveList list;
+            MoveGenerator::add_loud_moves(list, board, board.side_to_move());
+            n += list.length();
+        }
+        return n;
+    };
+}
+
+TEST_CASE("microbench make/unmake", "[.][microbench]")
+{
+    std::vector<Board> boards = corpus_boards();
+    std::vector<MoveList> lists(boards.size());
+    size_t moves = 0;
+    for (size_t i = 0; i < boards.size(); i++)
+    {
+        MoveGenerator::add_all_moves(lists[i], boards[i], boards[i].side_to_move());
+        moves += static_cast<size_t>(lists[i].length());
+    }
+
+    BENCHMARK(ops("do_move + undo_move, per move", moves))
+    {
+        U64 hash = 0;
+        for (size_t i = 0; i < boards.size(); i++)
+        {
+            for (int j = 0; j < lists[i].length(); j++)
+            {
+                boards[i].do_move(lists[i][j]);
+                hash ^= boards[i].get_hash();
+                boards[i].undo_move(lists[i][j]);
+            }
+        }
+        return hash;
+    };
+
+    for (size_t i = 0; i < boards.size(); i++)
+    {
+        CHECK(boards[i].get_hash() == Parser::parse_fen(BENCH_FENS[i]).get_hash());
+    }
+}
+
+TEST_CASE("microbench position copies", "[.][microbench]")
+{
+    std::vector<Board> boards = corpus_boards();
+
+    BENCHMARK(ops("Board copy, per position", boards.size()))
+    {
+        U64 hash = 0;
+        for (const Board& board : boards)
+        {
+            Board copy = board;
+            hash ^= copy.get_hash();
+        }
+        return hash;
+    };
+
+    BENCHMARK(ops("Position copy, per position", boards.size()))
+    {
+        U64 hash = 0;
+        for (const Board& board : boards)
+        {
+            Position copy = board.position();
+            hash ^= copy.state.hash;
+        }
+        return hash;
+    };
+
+    // The mailbox against recovering each piece from the bitboards alone
+    BENCHMARK(ops("piece lookup, mailbox, per square", boards.size() * 64))
+    {
+        int sum = 0;
+        for (const Board& board : boards)
+        {
+            const Position& pos = board.position();
+            for (int sq = 0; sq < 64; sq++)
+            {
+                sum += pos[sq];
+            }
+        }
+        return sum;
+    };
+
+    BENCHMARK(ops("piece lookup, bitboards, per square", boards.size() * 64))
+    {
+        int sum = 0;
+        for (const Board& board : boards)
+        {
+            const Position& pos = board.position();
+            for (int sq = 0; sq < 64; sq++)
+            {
+                U64 bit = 1ULL << sq;
+                for (U8 piece = WHITE_PAWN; piece <= BLACK_KING; piece++)
+                {
+                    if (pos.bitboard(piece) & bit)
+                    {
+                        sum += piece;
+                        break;
+                    }
+                }
+            }
+        }
+        return sum;
+    };
+}
+
+TEST_CASE("microbench SEE and in_check", "[.][microbench]")
+{
+    std::vector<Board> boards = corpus_boards();
+    std::vector<std::vector<Move_t>> captures(boards.size());
+    size_t num_captures = 0;
+    for (size_t i = 0; i < boards.size(); i++)
+    {
+        MoveList list;
+        MoveGenerator::add_loud_moves(list, boards[i], boards[i].side_to_move());
+        for (int j = 0; j < list.length(); j++)
+        {
+            if (is_capture(list[j]))
+            {
+                captures[i].push_back(list[j]);
+            }
+        }
+        num_captures += captures[i].size();
+    }
+    REQUIRE(num_captures > 0);
+
+    BENCHMARK(ops("see, per capture", num_captures))
+    {
+        int sum = 0;
+        for (size_t i = 0; i < boards.size(); i++)
+        {
+            for (Move_t move : captures[i])
+            {
+                sum += MoveGenerator::see(boards[i], move);
+            }
+        }
+        return sum;
+    };
+
+    BENCHMARK(ops("see_ge(0), per capture", num_captures))
+    {
+        int n = 0;
+        for (size_t i = 0; i < boards.size(); i++)
+        {
+            for (Move_t move : captures[i])
+            {
+                n += MoveGenerator::see_ge(boards[i], move, 0);
+            }
+        }
+        return n;
+    };
+
+    BENCHMARK(ops("in_check, per position", boards.size()))
+    {
+        int n = 0;
+        for (const Board& board : boards)
+        {
+            n += MoveGenerator::in_check(board, board.side_to_move()) ? 1 : 0;
+        }
+        return n;
+    };
+}
+
+// Deterministic weights in the layout NNUEEvaluator::load() expects. The
+// values do not matter for timing, only the network shape does.
+static std::string write_bench_weights()
+{
+    std::string path = "microbench_nnue_weights.bin";
+    std::ofstream f(path, std::ios::binary);
+    const int sizes[] = {
+        NNUEEvaluator::INPUT_SIZE * NNUEEvaluator::L1_SIZE, NNUEEvaluator::L1_SIZE,
+        NNUEEvaluator::L1_SIZE * 2 * NNUEEvaluator::L2_SIZE, NNUEEvaluator::L2_SIZE,
+        NNUEEvaluator::L2_SIZE * NNUEEvaluator::L3_SIZE,     NNUEEvaluator::L3_SIZE,
+        NNUEEvaluator::L3_SIZE * NNUEEvaluator::OUTPUT_SIZE, NNUEEvaluator::OUTPUT_SIZE,
+    };
+    for (int size : sizes)
+    {
+        for (int i = 0; i < size; i++)
+        {
+            int16_t value = static_cast<int16_t>(i % 7 - 3);
+            f.write(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+    }
+    return path;
+}
+
+TEST_CASE("microbench evaluation", "[.][microbench]")
+{
+    std::vector<Board> boards = corpus_boards();
+
+    BENCHMARK(ops("hce side_relative_eval, per position", boards.size()))
+    {
+        int sum = 0;
+        for (Board& board : boards)
+        {
+            sum += board.get_hce().side_relative_eval(board);
+        }
+        return sum;
+    };
+
+    std::string path = write_bench_weights();
+    NNUEEvaluator nnue;
+    bool loaded = nnue.load(path);
+    std::remove(path.c_str());
+    REQUIRE(loaded);
+
+    BENCHMARK(ops("nnue refresh + evaluate, per position", boards.size()))
+    {
+        int sum = 0;
+        for (const Board& board : boards)
+        {
+            nnue.refresh(board);
+            sum += nnue.side_relative_eval(board);
+        }
+        return sum;
+    };
+
+    // The accumulator is kept up to date by do_move/undo_move, as in search
+    std::vector<MoveList> lists(boards.size());
+    size_t moves = 0;
+    for (size_t i = 0; i < boards.size(); i++)
+    {
+        MoveGenerator::add_all_moves(lists[i], boards[i], boards[i].side_to_move());
+        moves += static_cast<size_t>(lists[i].length());
+    }
+
+    BENCHMARK(ops("nnue do_move + evaluate + undo_move, per move", moves))
+    {
+        int sum = 0;
+        for (size_t i = 0; i < boards.size(); i++)
+        {
+            boards[i].set_nnue(&nnue);
+            nnue.refresh(boards[i]);
+            for (int j = 0; j < lists[i].length(); j++)
+            {
+                boards[i].do_move(lists[i][j]);
+                sum += nnue.side_relative_eval(boards[i]);
+                boards[i].undo_move(lists[i][j]);
+            }
+            boards[i].set_nnue(nullptr);
+        }
+        return sum;
+    };
+}
+
+TEST_CASE("microbench slider attack backends", "[.][microbench]")
+{
+    // Occupancies from real positions, queried from every square
+    std::vector<U64> occupancies;
+    for (const Board& board : corpus_boards())
+    {
+        occupancies.push_back(board.bitboard(WHITE) | board.bitboard(BLACK));
+    }
+    size_t queries = occupancies.size() * 64;
+
+    for (U64 occ : occupancies)
+    {
+        for (int sq = 0; sq < 64; sq++)
+        {
+            REQUIRE(MoveGenerator::rook_attacks_magic(occ, sq)
+                    == (MoveGenerator::file_attacks_hyperbola(occ, sq)
+                        | MoveGenerator::rank_attacks_hyperbola(occ, sq)));
+            REQUIRE(MoveGenerator::bishop_attacks_magic(occ, sq)
+                    == (MoveGenerator::diag_attacks_hyperbola(occ, sq)
+                        | MoveGenerator::anti_diag_attacks_hyperbola(occ, sq)));
+        }
+    }
+
+    BENCHMARK(ops("rook + bishop attacks, magic", queries))
+    {
+        U64 acc = 0;
+        for (U64 occ : occupancies)
+        {
+            for (int sq = 0; sq < 64; sq++)
+            {
+                acc ^= MoveGenerator::rook_attacks_magic(occ, sq);
+                acc ^= MoveGenerator::bishop_attacks_magic(occ, sq);
+            }
+        }
+        return acc;
+    };
+
+    if (MoveGenerator::pext_available())
+    {
+        BENCHMARK(ops("rook + bishop attacks, pext", queries))
+        {
+            U64 acc = 0;
+            for (U64 occ : occupancies)
+            {
+                for (int sq = 0; sq < 64; sq++)
+                {
+                    acc ^= MoveGenerator::rook_attacks_pext(occ, sq);
+                    acc ^= MoveGenerator::bishop_attacks_pext(occ, sq);
+                }
+            }
+            return acc;
+        };
+    }
+
+    BENCHMARK(ops("rook + bishop attacks, hyperbola", queries))
+    {
+        U64 acc = 0;
+        for (U64 occ : occupancies)
+        {
+            for (int sq = 0; sq < 64; sq++)
+            {
+                acc ^= MoveGenerator::file_attacks_hyperbola(occ, sq)
+                    | MoveGenerator::rank_attacks_hyperbola(occ, sq);
+                acc ^= MoveGenerator::diag_attacks_hyperbola(occ, sq)
+                    | MoveGenerator::anti_diag_attacks_hyperbola(occ, sq);
+            }
+        }
+        return acc;
+    };
+
+    BENCHMARK(ops("rook + bishop attacks, ray loop", queries))
+    {
+        U64 acc = 0;
+        for (U64 occ : occupancies)
+        {
+            for (int sq = 0; sq < 64; sq++)
+            {
+                acc ^= MoveGenerator::rook_attacks_slow(occ, sq);
+                acc ^= MoveGenerator::bishop_attacks_slow(occ, sq);
+            }
+        }
+        return acc;
+    };
+}
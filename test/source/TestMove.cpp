@@ -60,3 +60,33 @@ TEST_CASE("move", "[move]")
     REQUIRE(is_capture(move));
     REQUIRE(is_ep_capture(move));
 }
+
+TEST_CASE("packed move round trips through the board", "[move]")
+{
+    // Castles, en passant, promotions with and without capture, both colours
+    const char* fens[] = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/Pp2P3/2N2Q1p/1PPBBPPP/R3K2R b KQkq a3 0 1",
+        "n1n5/PPPk4/8/8/8/8/4Kppp/5N1N b - - 0 1",
+        "n1n5/PPPk4/8/8/8/8/4Kppp/5N1N w - - 0 1",
+    };
+    for (const char* fen : fens)
+    {
+        Board board = Parser::parse_fen(fen);
+        MoveList list;
+        MoveGenerator::add_all_moves(list, board, board.side_to_move());
+        REQUIRE(list.length() > 0);
+        for (int i = 0; i < list.length(); i++)
+        {
+            PackedMove packed = pack_move(list[i]);
+            REQUIRE(!packed.is_null());
+            REQUIRE(unpack_move(packed, board) == list[i]);
+            for (int j = 0; j < i; j++)
+            {
+                REQUIRE(pack_move(list[j]) != packed);
+            }
+        }
+    }
+    REQUIRE(pack_move(Move(0U)).is_null());
+    REQUIRE(unpack_move(PackedMove(), Board()) == Move(0U));
+}
@@ -7,12 +7,14 @@
 
 #include "Tests.h"
 
+#include "LookupTables.h"
+
 TEST_CASE("move_generator_can_generate_rook_moves", "[move generator]")
 {
     cout << "- Can generate rook moves" << endl;
     Board board;
     board.add_piece(WHITE_ROOK, D2);
-    MoveList list;
+    PseudoMoveList list;
     // check normal moves
     MoveGenerator::add_rook_moves(list, board, board.side_to_move());
     // cout << Output::board(board);
@@ -68,7 +70,7 @@ TEST_CASE("move_generator_can_generate_bishop_moves", "[move generator]")
     cout << "- Can generate bishop moves" << endl;
     Board board;
     board.add_piece(WHITE_BISHOP, D2);
-    MoveList list;
+    PseudoMoveList list;
     // check normal moves
     MoveGenerator::add_bishop_moves(list, board, WHITE);
     // cout << Output::board(board);
@@ -126,7 +128,7 @@ TEST_CASE("move_generator_can_generate_pawn_pushes", "[move generator]")
     REQUIRE(board.bitboard(WHITE_PAWN) == 0xFF00ULL);
     REQUIRE(board.bitboard(WHITE) == 0xFF00ULL);
     REQUIRE(board.bitboard(BLACK) == 0x0ULL);
-    MoveList list;
+    PseudoMoveList list;
     MoveGenerator::add_pawn_pushes(list, board, WHITE);
     // check 8 pushes generated and 8 double pushes
     REQUIRE(list.length() == 16);
@@ -180,7 +182,7 @@ TEST_CASE("move_generator_can_generate_pawn_double_pushes", "[move generator]")
     board.add_piece(WHITE_PAWN, E2);
     // check we can calculate for black too
     board.add_piece(BLACK_PAWN, E7);
-    MoveList list;
+    PseudoMoveList list;
     MoveGenerator::add_pawn_pushes(list, board, WHITE);
     // last two moves should be double pushes
     REQUIRE(list.length() == 10);
@@ -206,7 +208,7 @@ TEST_CASE("move_generator_can_generate_pawn_attacks", "[move generator]")
     board.add_piece(WHITE_PAWN, C4);
     board.add_piece(BLACK_PAWN, B5);
     board.add_piece(BLACK_PAWN, C5);
-    MoveList list;
+    PseudoMoveList list;
     MoveGenerator::add_pawn_attacks(list, board, WHITE);
 
     REQUIRE(list.length() == 3);
@@ -232,7 +234,7 @@ TEST_CASE("move_generator_can_generate_pawn_promotions", "[move generator]")
     Board board;
     board.add_piece(WHITE_PAWN, C7);
     board.add_piece(BLACK_PAWN, C2);
-    MoveList list;
+    PseudoMoveList list;
     MoveGenerator::add_pawn_pushes(list, board, WHITE);
     REQUIRE(list.length() == 4);
     REQUIRE(list.contains_valid_moves(board));
@@ -263,7 +265,7 @@ TEST_CASE("move_generator_can_generate_pawn_capture_promotions", "[move generato
     board.add_piece(BLACK_PAWN, C2);
     board.add_piece(WHITE_KNIGHT, C1);
     board.add_piece(WHITE_ROOK, D1);
-    MoveList list;
+    PseudoMoveList list;
     MoveGenerator::add_pawn_attacks(list, board, WHITE);
     REQUIRE(list.length() == 4);
     REQUIRE(list.contains_valid_moves(board));
@@ -290,7 +292,7 @@ TEST_CASE("move_generator_can_generate_pawn_en_passant_attacks", "[move generato
     board.add_piece(BLACK_PAWN, C5);
     board.add_piece(WHITE_PAWN, D5);
     board.set_ep_square(C6);
-    MoveList list;
+    PseudoMoveList list;
     MoveGenerator::add_pawn_attacks(list, board, WHITE);
     // cout << Output::board(board);
     // cout << Output::movelist(list, board);
@@ -314,7 +316,7 @@ TEST_CASE("move_generator_can_generate_knight_moves", "[move generator]")
     cout << "- Can generate knight moves" << endl;
     Board board;
     board.add_piece(WHITE_KNIGHT, D4);
-    MoveList list;
+    PseudoMoveList list;
     // check normal moves
     MoveGenerator::add_knight_moves(list, board, WHITE);
     REQUIRE(list.length() == 8);
@@ -358,7 +360,7 @@ TEST_CASE("move_generator_can_generate_king_moves", "[move generator]")
     cout << "- Can generate king moves" << endl;
     Board board;
     board.add_piece(WHITE_KING, D4);
-    MoveList list;
+    PseudoMoveList list;
     // check normal moves
     MoveGenerator::add_king_moves(list, board, WHITE);
     REQUIRE(list.length() == 8);
@@ -950,3 +952,80 @@ TEST_CASE("move_generator_cant_castle_when_rook_passes_through_attack", "[move g
     REQUIRE(list.contains(build_castle(QUEEN_CASTLE)));
     list.reset();
 }
+
+TEST_CASE("move_generator_magic_tables_match_slow_attacks", "[move generator]")
+{
+    // Every blocker subset of every square's mask, so every entry of the
+    // packed attack tables is checked once
+    for (int sq = 0; sq < 64; sq++)
+    {
+        U64 blockers = 0ULL;
+        do
+        {
+            REQUIRE(MoveGenerator::rook_attacks_magic(blockers, sq)
+                    == MoveGenerator::rook_attacks_slow(blockers, sq));
+            blockers = (blockers - ROOK_MB_MASK[sq]) & ROOK_MB_MASK[sq];
+        } while (blockers != 0ULL);
+
+        do
+        {
+            REQUIRE(MoveGenerator::bishop_attacks_magic(blockers, sq)
+                    == MoveGenerator::bishop_attacks_slow(blockers, sq));
+            blockers = (blockers - BISHOP_MB_MASK[sq]) & BISHOP_MB_MASK[sq];
+        } while (blockers != 0ULL);
+
+        // Occupancy outside the mask (edges, the square itself) is ignored
+        U64 full = ~0ULL;
+        REQUIRE(MoveGenerator::rook_attacks_magic(full, sq)
+                == MoveGenerator::rook_attacks_slow(full, sq));
+        REQUIRE(MoveGenerator::bishop_attacks_magic(full, sq)
+                == MoveGenerator::bishop_attacks_slow(full, sq));
+    }
+}
+
+TEST_CASE("move_generator_pext_tables_match_slow_attacks", "[move generator]")
+{
+    if (!MoveGenerator::pext_available())
+    {
+        // No BMI2 (or slow PEXT, or built with -Dblunder_PEXT=OFF): stay on magics
+        REQUIRE_FALSE(MoveGenerator::set_slider_backend(MoveGenerator::SliderBackend::PEXT));
+        REQUIRE(MoveGenerator::slider_backend() == MoveGenerator::SliderBackend::MAGIC);
+        return;
+    }
+
+    for (int sq = 0; sq < 64; sq++)
+    {
+        U64 blockers = 0ULL;
+        do
+        {
+            REQUIRE(MoveGenerator::rook_attacks_pext(blockers, sq)
+                    == MoveGenerator::rook_attacks_slow(blockers, sq));
+            blockers = (blockers - ROOK_MB_MASK[sq]) & ROOK_MB_MASK[sq];
+        } while (blockers != 0ULL);
+
+        do
+        {
+            REQUIRE(MoveGenerator::bishop_attacks_pext(blockers, sq)
+                    == MoveGenerator::bishop_attacks_slow(blockers, sq));
+            blockers = (blockers - BISHOP_MB_MASK[sq]) & BISHOP_MB_MASK[sq];
+        } while (blockers != 0ULL);
+    }
+
+    // Both backends generate the same moves
+    MoveGenerator::SliderBackend saved = MoveGenerator::slider_backend();
+    Board board = Parser::parse_fen(
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    MoveList magic_list;
+    REQUIRE(MoveGenerator::set_slider_backend(MoveGenerator::SliderBackend::MAGIC));
+    MoveGenerator::add_all_moves(magic_list, board, board.side_to_move());
+    MoveList pext_list;
+    REQUIRE(MoveGenerator::set_slider_backend(MoveGenerator::SliderBackend::PEXT));
+    MoveGenerator::add_all_moves(pext_list, board, board.side_to_move());
+    MoveGenerator::set_slider_backend(saved);
+
+    REQUIRE(pext_list.length() == magic_list.length());
+    for (int i = 0; i < magic_list.length(); i++)
+    {
+        REQUIRE(pext_list.contains(magic_list[i]));
+    }
+}
@@ -41,3 +41,56 @@ TEST_CASE("move_list_can_pop", "[move list]")
     REQUIRE(list.length() == 0);
     REQUIRE(popped == move);
 }
+
+TEST_CASE("move_list_sort_picks_moves_by_descending_score", "[move list]")
+{
+    cout << "- Sort picks moves by descending score" << endl;
+    // A few loud scores, then enough quiets to take the insertion sort path
+    const int scores[] = { QUIET_MOVE_SCORE + 7,
+                           40 * MOVE_SCORE_SCALE,
+                           QUIET_MOVE_SCORE - 3,
+                           90 * MOVE_SCORE_SCALE,
+                           BAD_CAPTURE_SCORE,
+                           QUIET_MOVE_SCORE + 7,
+                           QUIET_MOVE_SCORE,
+                           80 * MOVE_SCORE_SCALE,
+                           QUIET_MOVE_SCORE + 5000,
+                           QUIET_MOVE_SCORE,
+                           BAD_CAPTURE_SCORE,
+                           QUIET_MOVE_SCORE - 5000 };
+    const int n = static_cast<int>(sizeof(scores) / sizeof(scores[0]));
+    class MoveList list = MoveList();
+    for (int i = 0; i < n; i++)
+    {
+        list.push(build_move(static_cast<U8>(i), static_cast<U8>(i + 16)));
+        list.set_score(i, scores[i]);
+    }
+
+    for (int i = 0; i < n; i++)
+    {
+        list.sort_moves(i);
+        // The move still carries its own score
+        REQUIRE(scores[move_from(list[i])] == list.get_score(i));
+        if (i > 0)
+        {
+            REQUIRE(list.get_score(i - 1) >= list.get_score(i));
+        }
+    }
+    REQUIRE(list.length() == n);
+    REQUIRE(!list.contains_duplicates());
+}
+
+TEST_CASE("move_list_holds_the_most_legal_moves", "[move list]")
+{
+    cout << "- Holds the most legal moves of any known position" << endl;
+    Board board = Parser::parse_fen("R6R/3Q4/1Q4Q1/4Q3/2Q4Q/Q4Q2/pp1Q4/kBNN1KB1 w - - 0 1");
+    MoveList list;
+    MoveGenerator::add_all_moves(list, board, board.side_to_move());
+    REQUIRE(list.length() == MAX_MOVELIST_LENGTH);
+    REQUIRE(!list.contains_duplicates());
+
+    PseudoMoveList pseudo;
+    MoveGenerator::add_queen_moves(pseudo, board, WHITE);
+    MoveGenerator::add_rook_moves(pseudo, board, WHITE);
+    REQUIRE(pseudo.length() <= MAX_PSEUDO_MOVELIST_LENGTH);
+}
@@ -18,6 +18,7 @@
 #include "MoveList.h"
 #include "NNUEEvaluator.h"
 #include "Parser.h"
+#include "Perft.h"
 
 // ---------------------------------------------------------------------------
 // Helper: generate a temporary binary weights file with deterministic values.
@@ -260,3 +261,35 @@ TEST_CASE("NNUE fallback: get_evaluator returns NNUE when loaded", "[nnue]")
     board.set_nnue(nullptr);
     std::remove(path.c_str());
 }
+
+// ===========================================================================
+// Test 10: perft_verify checks the accumulator along the tree
+// ===========================================================================
+TEST_CASE("NNUE accumulator stays consistent along a perft tree", "[nnue]")
+{
+    auto path = generate_test_weights("verify");
+
+    NNUEEvaluator nnue;
+    REQUIRE(nnue.load(path));
+
+    Board board =
+        Parser::parse_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    board.set_nnue(&nnue);
+    nnue.refresh(board);
+    REQUIRE(nnue.accumulator_matches(board));
+
+    PerftVerifyResult result = perft_verify(board, 2);
+    REQUIRE(result.ok);
+    REQUIRE(result.nodes > 2000);
+
+    // A stray incremental update must be caught at the root
+    nnue.add_piece(WHITE_QUEEN, A3);
+    REQUIRE_FALSE(nnue.accumulator_matches(board));
+    result = perft_verify(board, 2);
+    REQUIRE_FALSE(result.ok);
+    REQUIRE(result.line.empty());
+    REQUIRE(result.error.find("NNUE") != std::string::npos);
+
+    board.set_nnue(nullptr);
+    std::remove(path.c_str());
+}
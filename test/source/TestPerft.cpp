@@ -8,6 +8,10 @@
 
 #include "Tests.h"
 
+#include <cstring>
+
+#include "ChildPosition.h"
+
 TEST_CASE("perft starting position depth 1", "[perft]")
 {
     // https://www.chessprogramming.org/Perft_Results#Initial_Position
@@ -160,3 +164,117 @@ TEST_CASE("perft starting position benchmark", "[perft]")
         return perft_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 4);
     };
 }
+
+TEST_CASE("perft parallel with hash matches perft", "[perft]")
+{
+    // https://www.chessprogramming.org/Perft_Results#Position_2
+    Board board =
+        Parser::parse_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -");
+    REQUIRE(perft_parallel(board, 4) == 4085603);
+    REQUIRE(perft_parallel(board, 4, 3) == 4085603);
+    REQUIRE(perft_parallel(board, 4, 3, 1) == 4085603);
+}
+
+TEST_CASE("perft divide sums to perft", "[perft]")
+{
+    Board board = Parser::parse_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+    std::vector<PerftDivide> moves = perft_divide(board, 3, 2, 1);
+    REQUIRE(moves.size() == 20);
+    U64 total = 0;
+    for (const PerftDivide& entry : moves)
+    {
+        REQUIRE(entry.nodes > 0);
+        total += entry.nodes;
+    }
+    REQUIRE(total == 8902);
+}
+
+TEST_CASE("perft suite", "[perft]")
+{
+    std::string suite = std::string(PROJECT_ROOT_DIR) + "/test/data/perft.epd";
+    REQUIRE(perft_suite(suite, 3, 2, 1) == 0);
+}
+
+TEST_CASE("perft verify finds no divergence", "[perft]")
+{
+    // Positions 2 and 4 cover castling, en passant and promotions
+    Board board =
+        Parser::parse_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    PerftVerifyResult result = perft_verify(board, 3);
+    REQUIRE(result.ok);
+    REQUIRE(result.error.empty());
+    REQUIRE(result.nodes == 1 + 48 + 2039 + 97862);
+
+    board = Parser::parse_fen("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1");
+    REQUIRE(perft_verify(board, 3).ok);
+}
+
+TEST_CASE("perft verify reports a corrupted hash", "[perft]")
+{
+    Board board = Parser::parse_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+    board.set_hash(board.get_hash() ^ 1);
+    PerftVerifyResult result = perft_verify(board, 2);
+    REQUIRE_FALSE(result.ok);
+    REQUIRE(result.nodes == 1);
+    REQUIRE(result.line.empty());
+    REQUIRE(result.error.find("hash") != std::string::npos);
+}
+
+TEST_CASE("perft children match board perft", "[perft]")
+{
+    // Positions 2-6 from https://www.chessprogramming.org/Perft_Results
+    struct
+    {
+        const char* fen;
+        int depth;
+        U64 nodes;
+    } cases[] = {
+        { "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -", 4, 4085603 },
+        { "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - -", 5, 674624 },
+        { "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 4, 422333 },
+        { "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 4, 2103487 },
+        { "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 4, 3894594 },
+    };
+    for (const auto& c : cases)
+    {
+        ChildPosition pos = ChildPosition::from_board(Parser::parse_fen(c.fen));
+        REQUIRE(perft_children(pos, c.depth) == c.nodes);
+    }
+}
+
+// Every child is the position Board::do_move reaches, for the same moves
+static void check_children(Board& board, int depth)
+{
+    ChildPosition pos = ChildPosition::from_board(board);
+    MoveList list;
+    MoveGenerator::add_all_moves(list, board, board.side_to_move());
+    REQUIRE(count_children(pos) == list.length());
+
+    ChildIterator children(pos);
+    REQUIRE(children.size() == list.length());
+    ChildPosition child;
+    Move_t move;
+    while (children.next(child, move))
+    {
+        REQUIRE(list.contains(move));
+        board.do_move(move);
+        ChildPosition expected = ChildPosition::from_board(board);
+        REQUIRE(std::memcmp(&child, &expected, sizeof(ChildPosition)) == 0);
+        if (depth > 1)
+        {
+            check_children(board, depth - 1);
+        }
+        board.undo_move(move);
+    }
+}
+
+TEST_CASE("child iterator matches do_move", "[perft]")
+{
+    Board board =
+        Parser::parse_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    check_children(board, 2);
+    board = Parser::parse_fen("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - -");
+    check_children(board, 3);
+    board = Parser::parse_fen("n1n5/PPPk4/8/8/8/8/4Kppp/5N1N b - - 0 1");
+    check_children(board, 2);
+}
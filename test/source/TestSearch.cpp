@@ -4,6 +4,14 @@
  */
 
 #include "Tests.h"
+#include "UCI.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
 
 #include <catch2/catch_test_macros.hpp>
 
@@ -77,3 +85,230 @@ TEST_CASE("search_black_mates_in_four_1", "[search]")
     Move_t move = search.search(8, -1);
     REQUIRE(move == build_capture(C6, C2, WHITE_PAWN));  // [ ...Rxc2+ Ka3 Rxa2+ Kxa2 Rc2+ ]
 }
+
+TEST_CASE("search_stops_at_hard_time_limit", "[search]")
+{
+    Board board = Parser::parse_fen(DEFAULT_FEN);
+    Search search(board);
+    auto start = std::chrono::steady_clock::now();
+    Move_t move = search.search(MAX_SEARCH_PLY, 100000);  // 0.1s
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    REQUIRE(move != 0U);
+    REQUIRE(elapsed < std::chrono::seconds(2));
+}
+
+TEST_CASE("search_stops_on_external_abort", "[search]")
+{
+    Board board = Parser::parse_fen(DEFAULT_FEN);
+    Search search(board);
+    std::thread stopper(
+        [&search]()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            search.set_abort(true);
+        });
+    auto start = std::chrono::steady_clock::now();
+    search.get_tm().start(-1, -1);
+    Move_t move = search.search(MAX_SEARCH_PLY, -1);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    stopper.join();
+    REQUIRE(move != 0U);
+    REQUIRE(elapsed < std::chrono::seconds(2));
+}
+
+TEST_CASE("stop_right_after_go_infinite_ends_the_search", "[search][uci]")
+{
+    // The stop can reach the engine before the search thread has entered
+    // search(); it must still end the search.
+    UCI uci;
+    std::ostringstream output;
+    std::istringstream input("position startpos\ngo infinite\nstop\nquit\n");
+    std::streambuf* old_cout = std::cout.rdbuf(output.rdbuf());
+    std::streambuf* old_cin = std::cin.rdbuf(input.rdbuf());
+    auto start = std::chrono::steady_clock::now();
+    uci.run();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    std::cin.rdbuf(old_cin);
+    std::cout.rdbuf(old_cout);
+    REQUIRE(output.str().find("bestmove") != string::npos);
+    REQUIRE(elapsed < std::chrono::seconds(2));
+
+    // Same at the Search level: a flag raised before search() is kept
+    Board board = Parser::parse_fen(DEFAULT_FEN);
+    Search search(board);
+    search.get_tm().start(-1, -1);
+    search.set_abort(true);
+    Move_t move = search.search(MAX_SEARCH_PLY, -1);
+    REQUIRE(move != 0U);
+    REQUIRE(search.get_completed_depth() == 0);
+}
+
+TEST_CASE("ponderhit_converts_infinite_search_to_timed", "[search]")
+{
+    Board board = Parser::parse_fen(DEFAULT_FEN);
+    Search search(board);
+    std::thread gui(
+        [&search]()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            search.ponderhit(100, 0, 0);  // 1s left on the clock
+        });
+    search.get_tm().start(-1, -1);
+    Move_t move = search.search(MAX_SEARCH_PLY, -1);
+    auto pondered_and_searched = search.get_tm().elapsed_us();
+    gui.join();
+    REQUIRE(move != 0U);
+    REQUIRE(search.get_tm().hard_limit() > 0);
+    REQUIRE(pondered_and_searched < 2000000);
+}
+
+TEST_CASE("clear_history_makes_search_reproducible", "[search]")
+{
+    // History and continuation history persist between searches; clearing
+    // them must bring the search back to exactly the same tree.
+    string fen = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+    Board board = Parser::parse_fen(fen);
+    Search search(board);
+    Move_t first = search.search(6, -1);
+    U64 first_nodes = search.get_stats().nodes_visited;
+
+    search.search(6, -1);
+    search.clear_history();
+    board.get_tt().clear();
+    Move_t second = search.search(6, -1);
+    REQUIRE(second == first);
+    REQUIRE(search.get_stats().nodes_visited == first_nodes);
+}
+
+TEST_CASE("history_gravity_saturates_at_the_bound", "[search]")
+{
+    int entry = 0;
+    for (int i = 0; i < 1000; i++)
+    {
+        update_history(entry, history_bonus(MAX_SEARCH_PLY));
+        REQUIRE(entry <= HISTORY_MAX);
+    }
+    REQUIRE(entry > HISTORY_MAX * 9 / 10);
+
+    int16_t narrow = 0;
+    for (int i = 0; i < 1000; i++)
+    {
+        update_history(narrow, -history_bonus(MAX_SEARCH_PLY));
+        REQUIRE(narrow >= -HISTORY_MAX);
+    }
+    REQUIRE(narrow < -HISTORY_MAX * 9 / 10);
+
+    // A saturated entry still moves back as soon as the sign flips
+    int before = entry;
+    update_history(entry, -history_bonus(4));
+    REQUIRE(entry < before);
+}
+
+static std::vector<int> quiet_history(const Search& search)
+{
+    std::vector<int> h;
+    for (int side = 0; side < 2; side++)
+    {
+        for (int from = 0; from < 64; from++)
+        {
+            for (int to = 0; to < 64; to++)
+            {
+                h.push_back(search.get_history(side, from, to));
+            }
+        }
+    }
+    return h;
+}
+
+TEST_CASE("history_persists_across_searches_until_cleared", "[search]")
+{
+    // With the TT cleared, a search from empty history is deterministic, so
+    // the tables only differ after a second search if it started from the
+    // first search's history.
+    string fen = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+    Board board = Parser::parse_fen(fen);
+    Search search(board);
+    search.search(5, -1);
+    std::vector<int> first = quiet_history(search);
+    REQUIRE(first != std::vector<int>(first.size(), 0));
+
+    board.get_tt().clear();
+    search.search(5, -1);
+    REQUIRE(quiet_history(search) != first);
+
+    search.clear_history();
+    REQUIRE(quiet_history(search) == std::vector<int>(first.size(), 0));
+    board.get_tt().clear();
+    search.search(5, -1);
+    REQUIRE(quiet_history(search) == first);
+}
+
+TEST_CASE("search_tree_stats_are_consistent", "[search]")
+{
+    string fen = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+    Board board = Parser::parse_fen(fen);
+    Search search(board);
+    search.search(6, -1);
+    const SearchTreeStats& tree = search.get_tree_stats();
+
+    if (!SEARCH_TREE_STATS)
+    {
+        REQUIRE(tree.total(TC_NODES) == 0);
+        return;
+    }
+    U64 nodes = tree.total(TC_NODES);
+    U64 typed = tree.total(TC_PV_NODES) + tree.total(TC_CUT_NODES) + tree.total(TC_ALL_NODES);
+    REQUIRE(nodes + tree.total(TC_QNODES) == search.get_stats().nodes_visited);
+    REQUIRE(typed <= nodes);
+    REQUIRE(tree.total(TC_FIRST_MOVE_CUTOFFS) <= tree.total(TC_CUT_NODES));
+    REQUIRE(tree.total(TC_NULL_CUTOFFS) <= tree.total(TC_NULL_TRIES));
+    REQUIRE(tree.total(TC_LMR_RESEARCHES) <= tree.total(TC_LMR_SEARCHES));
+    REQUIRE(tree.counts[0][TC_NODES] > 0);
+}
+
+TEST_CASE("search_tree_dump_records_every_node", "[search]")
+{
+    string fen = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+    string path = "search_tree_dump_test.bin";
+    Board board = Parser::parse_fen(fen);
+    Search search(board);
+    search.set_output_mode(Search::OutputMode::SILENT);
+    search.get_tm().start(-1, -1);
+    bool enabled = search.set_tree_dump(path, 1000000);
+    REQUIRE(enabled == SEARCH_TREE_DUMP_ENABLED);
+    if (!enabled)
+    {
+        return;
+    }
+    search.search(5, -1);
+
+    std::ifstream f(path, std::ios::binary);
+    char magic[8];
+    uint32_t record_size = 0;
+    f.read(magic, sizeof(magic));
+    f.read(reinterpret_cast<char*>(&record_size), sizeof(record_size));
+    REQUIRE(string(magic, 7) == "BLTREE1");
+    REQUIRE(record_size == sizeof(TreeDumpRecord));
+    std::vector<TreeDumpRecord> records;
+    TreeDumpRecord r;
+    while (f.read(reinterpret_cast<char*>(&r), sizeof(r)))
+    {
+        records.push_back(r);
+    }
+    f.close();
+    std::remove(path.c_str());
+
+    // One record per node, written after all of its children
+    REQUIRE(records.size() == static_cast<size_t>(search.get_stats().nodes_visited));
+    std::vector<bool> written(records.size() + 1, false);
+    for (const TreeDumpRecord& rec : records)
+    {
+        REQUIRE(rec.parent < rec.id);
+        REQUIRE(!written[rec.parent]);
+        written[rec.id] = true;
+        if (rec.parent == 0)
+        {
+            REQUIRE(rec.ply == 0);
+        }
+    }
+}
@@ -77,12 +77,12 @@ TEST_CASE("node_count_monotonic_with_depth", "[search properties]")
         Board board = Parser::parse_fen(SEARCH_PROP_FENS[i]);
         Search search(board);
 
-        int prev_nodes = 0;
+        U64 prev_nodes = 0;
         for (int depth = 1; depth <= 4; depth++)
         {
             board.get_tt().clear();
             search.search(depth, -1);
-            int nodes = search.get_stats().nodes_visited;
+            U64 nodes = search.get_stats().nodes_visited;
 
             INFO("FEN: " << SEARCH_PROP_FENS[i] << " depth: " << depth << " nodes: " << nodes
                          << " prev: " << prev_nodes);
@@ -114,6 +114,46 @@ TEST_CASE("see_equally_defended_capture", "[move generator see]")
     REQUIRE(seeTest("4k3/8/8/4q3/8/8/1Q6/4K3 w - -", "Qxe5") == SEE_PIECE_VALUE[QUEEN >> 1]);
 }
 
+TEST_CASE("see_ge_agrees_with_see", "[move generator see]")
+{
+    // Every legal move, captures and quiets, against thresholds around and
+    // between the piece values
+    const char* fens[] = {
+        "1k1r3q/1ppn3p/p4b2/4p3/8/P2N2P1/1PP1R1BP/2K1Q3 w - -",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -",
+        "7r/5qpk/p1Qp1b1p/3r3n/BB3p2/5p2/P1P2P2/4RK1R w - -",
+        "6RR/4bP2/8/8/5r2/3K4/5p2/4k3 w - -",
+        "4r1k1/5pp1/nbp4p/1p2p2q/1P2P1b1/1BP2N1P/1B2QPPK/3R4 b - -",
+        "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6",
+    };
+    const int thresholds[] =
+        { -2000, -900, -500, -325, -200, -100, -1, 0, 1, 100, 200, 325, 500, 900 };
+    int checked = 0;
+    for (const char* fen : fens)
+    {
+        Board board = Parser::parse_fen(fen);
+        MoveList list;
+        MoveGenerator::add_all_moves(list, board, board.side_to_move());
+        for (int i = 0; i < list.length(); i++)
+        {
+            Move_t move = list[i];
+            if (is_castle(move))
+            {
+                continue;
+            }
+            int value = MoveGenerator::see(board, move);
+            REQUIRE(MoveGenerator::see_ge(board, move, value));
+            REQUIRE(!MoveGenerator::see_ge(board, move, value + 1));
+            for (int threshold : thresholds)
+            {
+                REQUIRE(MoveGenerator::see_ge(board, move, threshold) == (value >= threshold));
+            }
+            checked++;
+        }
+    }
+    REQUIRE(checked > 0);
+}
+
 // Property 8: Quiescence search has no side effects on board state
 TEST_CASE("quiesce_no_side_effects", "[board invariance]")
 {
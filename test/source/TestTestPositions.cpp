@@ -3,7 +3,9 @@
  *
  */
 
+#include <cstdio>
 #include <fstream>
+#include <string>
 
 #include <catch2/catch_test_macros.hpp>
 
@@ -32,6 +34,75 @@ TEST_CASE("test_positions_STS-Rating", "[.][slow][test-positions]")
     CHECK(score >= (66757.0 / 118800));  // ELO=2259
 }
 
+TEST_CASE("test_positions_jobs_merge_deterministically", "[test-positions]")
+{
+    // First WAC positions plus two STS ones, to exercise the categories
+    std::string path = "test_positions_jobs.epd";
+    {
+        std::ifstream wac(test_positions_dir + "WAC.epd");
+        std::ifstream sts(test_positions_dir + "STS1-STS15_LAN_v6.epd");
+        std::ofstream out(path);
+        std::string line;
+        for (int i = 0; i < 6 && std::getline(wac, line); i++)
+        {
+            out << line << "\n";
+        }
+        for (int i = 0; i < 2 && std::getline(sts, line); i++)
+        {
+            out << line << "\n";
+        }
+    }
+
+    auto serial = test_positions_ex(path, SearchMode::FixedDepth, 4, 1);
+    auto parallel = test_positions_ex(path, SearchMode::FixedDepth, 4, 3);
+    std::remove(path.c_str());
+
+    REQUIRE(serial.max_score > 0);
+    CHECK(parallel.score == serial.score);
+    CHECK(parallel.max_score == serial.max_score);
+    CHECK(parallel.total_nodes == serial.total_nodes);
+    REQUIRE(parallel.categories.size() == serial.categories.size());
+    for (const auto& [name, cat] : serial.categories)
+    {
+        CHECK(parallel.categories[name].score == cat.score);
+        CHECK(parallel.categories[name].positions == cat.positions);
+    }
+    REQUIRE(parallel.positions.size() == serial.positions.size());
+    for (size_t i = 0; i < serial.positions.size(); i++)
+    {
+        CHECK(parallel.positions[i].id == serial.positions[i].id);
+        CHECK(parallel.positions[i].move == serial.positions[i].move);
+        CHECK(parallel.positions[i].nodes == serial.positions[i].nodes);
+    }
+}
+
+TEST_CASE("test_positions_json_has_records_and_summary", "[test-positions]")
+{
+    std::string path = "test_positions_json.epd";
+    {
+        std::ofstream out(path);
+        out << "2rr3k/pp3pp1/1nnqbN1p/3pN3/2pP4/2P3Q1/PPB4P/R4RK1 w - - bm Qg6; id \"WAC.001\";\n";
+        out << "8/7p/5k2/5p2/p1p2P2/Pr1pPK2/1P1R3P/8 b - - bm Rxb2; id \"WAC.002\";\n";
+    }
+    auto result = test_positions_ex(path, SearchMode::FixedDepth, 3, 1, true);
+    std::remove(path.c_str());
+
+    REQUIRE(result.positions.size() == 2);
+    CHECK(result.positions[0].id == "WAC.001");
+    CHECK(result.positions[0].depth == 3);
+    CHECK(result.positions[0].expected.size() == 1);
+    CHECK(result.positions[0].expected[0].first == "g3g6");
+    CHECK(result.positions[1].expected[0].first == "b3b2");
+
+    std::string json = test_positions_json(result);
+    CHECK(json.front() == '{');
+    CHECK(json.back() == '}');
+    CHECK(json.find("\"summary\":{\"positions\":2,") != std::string::npos);
+    CHECK(json.find("\"id\":\"WAC.001\"") != std::string::npos);
+    CHECK(json.find("\"expected\":[{\"move\":\"g3g6\",\"score\":1}]") != std::string::npos);
+    CHECK(json.find("\"tt_hit_rate\":") != std::string::npos);
+}
+
 // --- Fixed-depth benchmarks (Requirement 9.1) ---
 
 TEST_CASE("test_positions_WAC_depth8", "[.][slow][test-positions][fixed-depth]")
@@ -17,6 +17,7 @@ from bench.parsers import (
     format_benchmark_output,
     parse_benchmark_output,
     parse_fastchess_output,
+    parse_json_output,
 )
 
 # ---------------------------------------------------------------------------
@@ -220,6 +221,34 @@ def test_parse_benchmark_missing_optional_fields() -> None:
     assert r.time_secs == 0.0
 
 
+def test_parse_json_output() -> None:
+    """Parse --json output: summary, categories and per-position records."""
+    stdout = (
+        "NNUE: loaded weights from nn.bin\n"
+        '{"summary":{"positions":2,"searched":2,"score_pct":50,"score":100,'
+        '"max_score":200,"elo":1983,"nodes":6799,"time_secs":0.18,"nps":37764,'
+        '"mean_depth":4,"tt_hit_rate":0.03},'
+        '"categories":{"Undermine":{"score":100,"max_score":200,"positions":2}},'
+        '"positions":[{"id":"STS(v1.0) Undermine.001","category":"Undermine",'
+        '"valid":true,"move":"f4f5","expected":[{"move":"f4f5","score":100}],'
+        '"score":100,"max_score":100,"nodes":3000,"time_secs":0.08,"depth":4,'
+        '"tt_hit_rate":0.02}]}\n'
+    )
+    r, positions = parse_json_output(stdout)
+    assert r.score_pct == 50.0
+    assert r.score == 100
+    assert r.nodes == 6799
+    assert r.categories["Undermine"].positions == 2
+    assert positions[0]["move"] == "f4f5"
+    assert positions[0]["nodes"] == 3000
+
+
+def test_parse_json_output_invalid_raises() -> None:
+    """ValueError when the last line is not the JSON result."""
+    with pytest.raises(ValueError, match="Could not parse JSON"):
+        parse_json_output("Score=50.0% (150/300)\n")
+
+
 # ---------------------------------------------------------------------------
 # Unit tests — parse_fastchess_output
 # ---------------------------------------------------------------------------
@@ -0,0 +1,65 @@
+"""Unit tests for the speedtest comparison."""
+
+from __future__ import annotations
+
+import pytest
+
+from bench.parsers import SpeedSample, parse_speedtest_output
+from bench.speedtest import compare_samples, format_comparison, t_critical_95
+
+
+def _samples(nps: list[int], nodes: int = 1000) -> list[SpeedSample]:
+    return [SpeedSample(nodes=nodes, time_secs=nodes / n, nps=n) for n in nps]
+
+
+def test_parse_speedtest_output() -> None:
+    stdout = (
+        "speedtest depth 4 hash 16 eval hce rounds 2\n"
+        "sample 1 nodes 130072 time 0.157677 nps 824924\n"
+        "sample 2 nodes 130072 time 0.163206 nps 796978\n"
+        "speedtest mean nps 810951 stdev 19761\n"
+    )
+    samples = parse_speedtest_output(stdout)
+    assert samples == [
+        SpeedSample(nodes=130072, time_secs=0.157677, nps=824924),
+        SpeedSample(nodes=130072, time_secs=0.163206, nps=796978),
+    ]
+
+
+def test_t_critical_values() -> None:
+    assert t_critical_95(1) == 12.706
+    assert t_critical_95(21) == 2.060  # conservative: next table entry
+    assert t_critical_95(1000) == 1.960
+    assert t_critical_95(0) == float("inf")
+
+
+def test_compare_identical_binaries() -> None:
+    c = compare_samples(_samples([1000, 1010, 990]), _samples([1000, 1010, 990]))
+    assert c.pairs == 3
+    assert c.delta_pct == 0.0
+    assert c.ci_pct == 0.0
+    assert c.nodes_match
+    assert "not significant" in format_comparison(c)
+
+
+def test_compare_detects_consistent_speedup() -> None:
+    base = _samples([1000, 1030, 970, 1010, 990])
+    new = _samples([1020, 1051, 989, 1030, 1010])  # ~2% faster in every pair
+    c = compare_samples(base, new)
+    assert c.delta_pct == pytest.approx(2.0, abs=0.1)
+    assert 0.0 < c.ci_pct < 0.2
+    assert "significant" in format_comparison(c).splitlines()[-1]
+    assert "not significant" not in format_comparison(c)
+
+
+def test_compare_flags_node_count_change() -> None:
+    c = compare_samples(_samples([1000, 1000]), _samples([1000, 1000], nodes=999))
+    assert not c.nodes_match
+    assert "node counts differ" in format_comparison(c)
+
+
+def test_compare_requires_pairs() -> None:
+    with pytest.raises(ValueError):
+        compare_samples([], [])
+    with pytest.raises(ValueError):
+        compare_samples(_samples([1000]), _samples([1000, 1000]))
@@ -0,0 +1,82 @@
+"""Unit tests for the search tree dump reader."""
+
+from __future__ import annotations
+
+import struct
+
+import pytest
+
+from bench.treedump import (
+    FLAGS,
+    MAGIC,
+    build_tree,
+    largest_subtrees,
+    move_str,
+    parse_records,
+    summarize,
+)
+
+_RECORD = struct.Struct("<QIIIiiiHbBBBBB")
+
+
+def _record(node_id: int, parent: int, ply: int, flags: int = 0, move: int = 0) -> bytes:
+    return _RECORD.pack(0x1234 + node_id, node_id, parent, move, -50, 50, 7, flags,
+                        3 - ply, ply, 1, 0, 0, 0)
+
+
+def _dump(records: list[bytes]) -> bytes:
+    return MAGIC + struct.pack("<I", _RECORD.size) + b"".join(records)
+
+
+def _sample_tree():
+    # Root 1 with children 2 (which has child 3) and 4; post-order on disk
+    data = _dump([
+        _record(3, 2, 2, FLAGS["qnode"] | FLAGS["stand_pat"]),
+        _record(2, 1, 1, FLAGS["lmr"] | FLAGS["zero_window"], move=12 | (28 << 6)),
+        _record(4, 1, 1, FLAGS["tt_cutoff"]),
+        _record(1, 0, 0, FLAGS["beta_cutoff"]),
+    ])
+    return build_tree(parse_records(data))
+
+
+def test_parse_records_round_trip() -> None:
+    records = parse_records(_dump([_record(1, 0, 0, FLAGS["rfp"])]))
+    assert len(records) == 1
+    node = records[0]
+    assert (node.id, node.parent, node.ply, node.depth) == (1, 0, 0, 3)
+    assert (node.alpha, node.beta, node.result) == (-50, 50, 7)
+    assert node.flag_names() == ["rfp"]
+
+
+def test_parse_records_rejects_bad_header() -> None:
+    with pytest.raises(ValueError):
+        parse_records(b"NOTATREE" + struct.pack("<I", _RECORD.size))
+    with pytest.raises(ValueError):
+        parse_records(MAGIC + struct.pack("<I", 32))
+
+
+def test_build_tree_links_children_in_search_order() -> None:
+    tree = _sample_tree()
+    assert tree.roots == [1]
+    assert tree.nodes[1].children == [2, 4]
+    assert tree.nodes[2].children == [3]
+    assert [n.id for n in tree.path(3)] == [1, 2, 3]
+
+
+def test_largest_subtrees() -> None:
+    tree = _sample_tree()
+    assert [(size, n.id) for size, n in largest_subtrees(tree, 2)] == [(4, 1), (2, 2)]
+    assert [(size, n.id) for size, n in largest_subtrees(tree, 5, ply=1)] == [(2, 2), (1, 4)]
+
+
+def test_summarize_counts_flags() -> None:
+    text = summarize(_sample_tree())
+    assert "nodes 4 roots 1" in text
+    assert "tt_cutoff       1" in text
+    assert "stand_pat       1" in text
+
+
+def test_move_str() -> None:
+    assert move_str(0) == "-"
+    assert move_str(12 | (28 << 6)) == "e2e4"
+    assert move_str(64 << 16) == "O-O"